@@ -0,0 +1,254 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * End to end allocation benchmark against the fake DRM backend:
+ * drm_vs_get_align_size -> drm_vs_bo_config -> CREATE_DUMB -> ADDFB2,
+ * then RMFB and DESTROY_DUMB, for typical compositor buffers.
+ *
+ *   vs_bo_bench [-n iterations] [-p]
+ *
+ * -p allocates through drm_vs_bo_pool instead, one buffer per frame buffer.
+ * Each iteration swaps width and height, as a rotating swapchain does.
+ * Peak bytes are the most ever live in the fake device, created bytes the
+ * sum of all CREATE_DUMB sizes.
+ */
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vs_bo_fake.h"
+#include "vs_bo_helper.h"
+#include "vs_bo_pool.h"
+
+#define VS_BENCH_ITERATIONS 20000
+#define VS_BENCH_POOL_CACHE (256ull << 20)
+
+typedef struct _vs_bench_case {
+	const char *name;
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint64_t mod;
+} vs_bench_case;
+
+static const vs_bench_case vs_bench_cases[] = {
+	{ "ui argb8888 linear", 1080, 2400, DRM_FORMAT_ARGB8888, DRM_FORMAT_MOD_LINEAR },
+	{ "ui argb8888 dec400 32x8", 1080, 2400, DRM_FORMAT_ARGB8888,
+	  fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_32X8, DRM_FORMAT_MOD_VS_DEC_ALIGN_32) },
+	{ "ui argb8888 dec400a", 1080, 2400, DRM_FORMAT_ARGB8888,
+	  fourcc_mod_vs_code(DRM_FORMAT_MOD_VS_TYPE_DEC400A, DRM_FORMAT_MOD_VS_DEC_LINEAR) },
+	{ "cursor argb8888 linear", 64, 64, DRM_FORMAT_ARGB8888, DRM_FORMAT_MOD_LINEAR },
+	{ "video nv12 linear", 1920, 1080, DRM_FORMAT_NV12, DRM_FORMAT_MOD_LINEAR },
+	{ "video nv12 dec400 32x8", 1920, 1080, DRM_FORMAT_NV12,
+	  fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_32X8, DRM_FORMAT_MOD_VS_DEC_ALIGN_32) },
+	{ "video p010 dec400 16x8", 3840, 2160, DRM_FORMAT_P010,
+	  fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_16X8, DRM_FORMAT_MOD_VS_DEC_ALIGN_32) },
+	{ "video p010 pvric 8x8", 3840, 2160, DRM_FORMAT_P010,
+	  fourcc_mod_vs_code(DRM_FORMAT_MOD_VS_TYPE_PVRIC, DRM_FORMAT_MOD_VS_DEC_TILE_8X8) },
+	{ "camera nv12 linear", 4000, 3000, DRM_FORMAT_NV12, DRM_FORMAT_MOD_LINEAR },
+};
+
+static inline uint64_t _vs_bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int _vs_bench_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* one frame buffer with one dumb buffer per plane, as drm_vs_bo_config lays it out */
+static int _vs_bench_planes(const drm_vs_bo_backend *backend, uint32_t width, uint32_t height,
+			    uint32_t format, uint64_t mod)
+{
+	struct drm_mode_fb_cmd2 fb;
+	drm_vs_bo_param bo_param[4];
+	uint32_t handles[4] = { 0 };
+	uint32_t i, num_planes = 0;
+	uint64_t size;
+	int ret;
+
+	drm_vs_get_align_size(&width, &height, format, mod);
+	ret = drm_vs_bo_config(width, height, format, mod, bo_param);
+	if (ret)
+		return ret;
+
+	for (num_planes = 0; num_planes < 4 && bo_param[num_planes].bpp; num_planes++) {
+		ret = backend->create(backend->priv, bo_param[num_planes].width,
+				      bo_param[num_planes].height, bo_param[num_planes].bpp,
+				      &handles[num_planes], &size);
+		if (ret)
+			goto out;
+	}
+
+	ret = drm_vs_fill_fb_cmd2(width, height, format, mod, handles, num_planes, &fb);
+	if (!ret)
+		ret = backend->add_fb(backend->priv, &fb);
+	if (!ret)
+		backend->rm_fb(backend->priv, fb.fb_id);
+
+out:
+	for (i = 0; i < num_planes; i++)
+		backend->destroy(backend->priv, handles[i]);
+
+	return ret;
+}
+
+/* one frame buffer in a single buffer of @pool */
+static int _vs_bench_pool(const drm_vs_bo_backend *backend, drm_vs_bo_pool *pool, uint32_t width,
+			  uint32_t height, uint32_t format, uint64_t mod)
+{
+	struct drm_mode_fb_cmd2 fb;
+	drm_vs_pool_bo bo;
+	int ret;
+
+	ret = drm_vs_bo_pool_alloc(pool, width, height, format, mod, &bo);
+	if (ret)
+		return ret;
+
+	ret = drm_vs_fill_fb_cmd2(width, height, format, mod, &bo.handle, 1, &fb);
+	if (!ret)
+		ret = backend->add_fb(backend->priv, &fb);
+	if (!ret)
+		backend->rm_fb(backend->priv, fb.fb_id);
+
+	drm_vs_bo_pool_free(pool, &bo);
+
+	return ret;
+}
+
+static int _vs_bench_run(const vs_bench_case *bench, uint32_t iterations, bool use_pool,
+			 uint64_t *lat)
+{
+	drm_vs_bo_backend backend;
+	drm_vs_bo_pool *pool = NULL;
+	vs_fake_drm fake;
+	uint64_t start, end, total = 0;
+	uint32_t i, width, height;
+	int ret = 0;
+
+	vs_fake_drm_init(&fake, &backend);
+	if (use_pool) {
+		pool = drm_vs_bo_pool_create(&backend, VS_BENCH_POOL_CACHE);
+		if (!pool) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	for (i = 0; i < iterations; i++) {
+		width = i & 1 ? bench->height : bench->width;
+		height = i & 1 ? bench->width : bench->height;
+
+		start = _vs_bench_now();
+		ret = use_pool ? _vs_bench_pool(&backend, pool, width, height, bench->format,
+						bench->mod) :
+				 _vs_bench_planes(&backend, width, height, bench->format,
+						  bench->mod);
+		end = _vs_bench_now();
+		if (ret) {
+			fprintf(stderr, "%s: %ux%u failed: %d\n", bench->name, width, height, ret);
+			goto out;
+		}
+
+		lat[i] = end - start;
+		total += lat[i];
+	}
+
+	qsort(lat, iterations, sizeof(*lat), _vs_bench_cmp);
+	printf("%-26s %10.0f %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %12" PRIu64
+	       " %14" PRIu64 " %8" PRIu64 " %6" PRIu64 "\n",
+	       bench->name, total ? iterations * 1e9 / total : 0.0, lat[iterations / 2],
+	       lat[iterations * 99 / 100], lat[iterations * 999 / 1000], lat[iterations - 1],
+	       fake.peak_bytes, fake.total_bytes, fake.creates, fake.errors);
+
+	if (fake.errors)
+		ret = -EINVAL;
+
+out:
+	drm_vs_bo_pool_destroy(pool);
+	vs_fake_drm_fini(&fake);
+
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t iterations = VS_BENCH_ITERATIONS, i;
+	bool use_pool = false;
+	uint64_t *lat;
+	int opt, ret = 0;
+
+	while ((opt = getopt(argc, argv, "n:p")) != -1) {
+		switch (opt) {
+		case 'n':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			use_pool = true;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations] [-p]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (!iterations)
+		return 1;
+
+	lat = malloc(iterations * sizeof(*lat));
+	if (!lat)
+		return 1;
+
+	printf("%s path, %u frame buffers per case, latency in ns\n",
+	       use_pool ? "drm_vs_bo_pool" : "per-plane dumb buffer", iterations);
+	printf("%-26s %10s %8s %8s %8s %8s %12s %14s %8s %6s\n", "case", "ops/s", "p50", "p99",
+	       "p99.9", "max", "peak bytes", "created bytes", "creates", "errors");
+
+	for (i = 0; i < sizeof(vs_bench_cases) / sizeof(vs_bench_cases[0]); i++) {
+		if (_vs_bench_run(&vs_bench_cases[i], iterations, use_pool, lat))
+			ret = 1;
+	}
+
+	free(lat);
+
+	return ret;
+}
@@ -0,0 +1,172 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <drm/vs_drm.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vs_bo_fake.h"
+#include "vs_bo_helper.h"
+
+#define VS_FAKE_PAGE_SIZE 4096ull
+
+static vs_fake_bo *_vs_fake_get_bo(vs_fake_drm *fake, uint32_t handle)
+{
+	if (!handle || handle > fake->num_bos || !fake->bos[handle - 1].live)
+		return NULL;
+
+	return &fake->bos[handle - 1];
+}
+
+/* same checks and size as drm_mode_create_dumb() and drm_gem_dumb_create() */
+static int _vs_fake_create(void *priv, uint32_t width, uint32_t height, uint32_t bpp,
+			   uint32_t *handle, uint64_t *size)
+{
+	vs_fake_drm *fake = priv;
+	uint64_t cpp = (bpp + 7) / 8, pitch = cpp * width;
+	vs_fake_bo *bos, *bo;
+	uint32_t num, i;
+
+	if (!width || !height || !bpp || pitch > UINT32_MAX || height > UINT32_MAX / pitch) {
+		fake->errors++;
+		return -EINVAL;
+	}
+
+	if (!fake->free_handle) {
+		num = fake->num_bos ? fake->num_bos * 2 : 64;
+		bos = realloc(fake->bos, num * sizeof(*bos));
+		if (!bos)
+			return -ENOMEM;
+
+		memset(&bos[fake->num_bos], 0, (num - fake->num_bos) * sizeof(*bos));
+		/* chain the new handles, lowest first as the kernel idr does */
+		for (i = num; i > fake->num_bos; i--) {
+			bos[i - 1].next_free = fake->free_handle;
+			fake->free_handle = i;
+		}
+		fake->bos = bos;
+		fake->num_bos = num;
+	}
+
+	*handle = fake->free_handle;
+	bo = &fake->bos[*handle - 1];
+	fake->free_handle = bo->next_free;
+
+	bo->width = width;
+	bo->height = height;
+	bo->bpp = bpp;
+	bo->size = (pitch * height + VS_FAKE_PAGE_SIZE - 1) & ~(VS_FAKE_PAGE_SIZE - 1);
+	bo->live = true;
+	*size = bo->size;
+
+	fake->creates++;
+	fake->live_bytes += bo->size;
+	fake->total_bytes += bo->size;
+	if (fake->live_bytes > fake->peak_bytes)
+		fake->peak_bytes = fake->live_bytes;
+
+	return 0;
+}
+
+static void _vs_fake_destroy(void *priv, uint32_t handle)
+{
+	vs_fake_drm *fake = priv;
+	vs_fake_bo *bo = _vs_fake_get_bo(fake, handle);
+
+	if (!bo) {
+		fake->errors++;
+		return;
+	}
+
+	bo->live = false;
+	bo->next_free = fake->free_handle;
+	fake->free_handle = handle;
+
+	fake->destroys++;
+	fake->live_bytes -= bo->size;
+}
+
+/* every plane must fit its buffer, as drm_framebuffer_check() requires */
+static int _vs_fake_add_fb(void *priv, struct drm_mode_fb_cmd2 *fb)
+{
+	vs_fake_drm *fake = priv;
+	drm_vs_format_desc desc;
+	const vs_fake_bo *bo;
+	uint32_t i;
+
+	if (drm_vs_get_format_desc(fb->pixel_format, fb->modifier[0], &desc))
+		goto err;
+
+	for (i = 0; i < desc.num_planes; i++) {
+		bo = _vs_fake_get_bo(fake, fb->handles[i]);
+		if (!bo || !fb->pitches[i])
+			goto err;
+		if ((uint64_t)fb->offsets[i] + (uint64_t)fb->pitches[i] * (fb->height / desc.vsub[i]) >
+		    bo->size)
+			goto err;
+	}
+
+	fb->fb_id = ++fake->next_fb;
+	fake->add_fbs++;
+	fake->live_fbs++;
+
+	return 0;
+
+err:
+	fake->errors++;
+	return -EINVAL;
+}
+
+static void _vs_fake_rm_fb(void *priv, uint32_t fb_id)
+{
+	vs_fake_drm *fake = priv;
+
+	if (!fb_id || fb_id > fake->next_fb || !fake->live_fbs) {
+		fake->errors++;
+		return;
+	}
+
+	fake->rm_fbs++;
+	fake->live_fbs--;
+}
+
+void vs_fake_drm_init(vs_fake_drm *fake, drm_vs_bo_backend *backend)
+{
+	memset(fake, 0, sizeof(*fake));
+
+	backend->create = _vs_fake_create;
+	backend->destroy = _vs_fake_destroy;
+	backend->add_fb = _vs_fake_add_fb;
+	backend->rm_fb = _vs_fake_rm_fb;
+	backend->priv = fake;
+}
+
+void vs_fake_drm_fini(vs_fake_drm *fake)
+{
+	free(fake->bos);
+	memset(fake, 0, sizeof(*fake));
+}
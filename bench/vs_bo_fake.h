@@ -0,0 +1,85 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * In-process stand-in for the DRM dumb buffer and frame buffer ioctls,
+ * for hosts without display hardware. Requests are checked as the kernel
+ * does and every buffer size is recorded.
+ */
+
+#ifndef __VS_BO_FAKE_H__
+#define __VS_BO_FAKE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "vs_bo_pool.h"
+
+typedef struct vs_fake_bo {
+	/* DRM_IOCTL_MODE_CREATE_DUMB request and resulting size */
+	uint32_t width;
+	uint32_t height;
+	uint32_t bpp;
+	uint64_t size;
+	bool live;
+	/* next free handle when not live */
+	uint32_t next_free;
+} vs_fake_bo;
+
+typedef struct vs_fake_drm {
+	/* buffers indexed by handle - 1 */
+	vs_fake_bo *bos;
+	uint32_t num_bos;
+	uint32_t free_handle;
+	uint32_t next_fb;
+
+	uint64_t creates;
+	uint64_t destroys;
+	uint64_t add_fbs;
+	uint64_t rm_fbs;
+	/* requests the kernel would have rejected */
+	uint64_t errors;
+
+	uint64_t live_fbs;
+	uint64_t live_bytes;
+	uint64_t peak_bytes;
+	/* bytes of all buffers ever created */
+	uint64_t total_bytes;
+} vs_fake_drm;
+
+/*
+ * Initialize @fake and fill @backend with its callbacks.
+ *
+ * @fake: the fake device.
+ *
+ * @backend: point to the backend to fill.
+ */
+void vs_fake_drm_init(vs_fake_drm *fake, drm_vs_bo_backend *backend);
+
+/* Release the bookkeeping of @fake, buffers still live are dropped. */
+void vs_fake_drm_fini(vs_fake_drm *fake);
+
+#endif /* __VS_BO_FAKE_H__ */
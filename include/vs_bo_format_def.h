@@ -0,0 +1,567 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Format and modifier descriptor data.
+ *
+ * This is the single source of truth for plane layouts, alignment rules
+ * and tile geometry. Every list is an X-macro: the includer defines the
+ * item macro, expands the list and gets a table out of it at build time.
+ */
+
+#ifndef __VS_BO_FORMAT_DEF_H__
+#define __VS_BO_FORMAT_DEF_H__
+
+#include <drm/vs_drm_fourcc.h>
+#include <stdint.h>
+
+/* modifier family, i.e. which sub-IP the modifier type selects */
+typedef enum _vs_mod_family {
+	VS_MOD_FAMILY_NORMAL,
+	VS_MOD_FAMILY_DEC400,
+	VS_MOD_FAMILY_DEC400A,
+	VS_MOD_FAMILY_PVRIC,
+	VS_MOD_FAMILY_DECNANO,
+	VS_MOD_FAMILY_ETC2,
+	/* any modifier type not listed above */
+	VS_MOD_FAMILY_OTHER,
+	VS_MOD_FAMILY_COUNT,
+} vs_mod_family;
+
+/*
+ * VS_MOD_TYPE(type, family)
+ *
+ * Modifier family of each modifier type, @type being the
+ * DRM_FORMAT_MOD_VS_TYPE_ suffix and @family the VS_MOD_FAMILY_ one.
+ * Unlisted types are VS_MOD_FAMILY_OTHER.
+ */
+#define VS_MOD_TYPE_LIST(VS_MOD_TYPE)         \
+	VS_MOD_TYPE(NORMAL, NORMAL)           \
+	VS_MOD_TYPE(COMPRESSED, DEC400)       \
+	VS_MOD_TYPE(DEC400A, DEC400A)         \
+	VS_MOD_TYPE(PVRIC, PVRIC)             \
+	VS_MOD_TYPE(DECNANO, DECNANO)         \
+	VS_MOD_TYPE(ETC2, ETC2)
+
+/*
+ * Format class, groups the formats which share the same
+ * format specific alignment and tile geometry rules.
+ */
+typedef enum _vs_format_class {
+	VS_FORMAT_CLASS_DEFAULT,
+	/* YUV formats with 2x2 aligned linear layout */
+	VS_FORMAT_CLASS_YUV,
+	/* YUYV and UYVY */
+	VS_FORMAT_CLASS_YUYV,
+	VS_FORMAT_CLASS_P010,
+	/* NV12 and NV21 */
+	VS_FORMAT_CLASS_NV12,
+	/* YUV420 and YVU420 */
+	VS_FORMAT_CLASS_YUV420,
+	VS_FORMAT_CLASS_YUV444,
+	/* RGB565 and BGR565 */
+	VS_FORMAT_CLASS_RGB565,
+	VS_FORMAT_CLASS_COUNT,
+	/* rule applies to every format class */
+	VS_FORMAT_CLASS_ANY = VS_FORMAT_CLASS_COUNT,
+} vs_format_class;
+
+/* plane layout variant, selected by the modifier */
+typedef enum _vs_layout_variant {
+	VS_LAYOUT_STANDARD,
+	/* fourcc_mod_is_custom_format() modifiers */
+	VS_LAYOUT_CUSTOM,
+	/* DEC400A modifiers, regardless of the custom flag */
+	VS_LAYOUT_DEC400A,
+	VS_LAYOUT_COUNT,
+} vs_layout_variant;
+
+typedef struct _vs_plane_desc {
+	uint8_t bpp;
+	/* plane width/height is the buffer width/height divided by these */
+	uint8_t width_div;
+	uint8_t height_div;
+} vs_plane_desc;
+
+typedef struct _vs_layout_desc {
+	/* 0 if the format is unsupported in this variant */
+	uint8_t num_planes;
+	vs_plane_desc plane[3];
+} vs_layout_desc;
+
+/*
+ * vs_layout_desc initializers.
+ * Each plane is { bpp, width divisor, height divisor }.
+ */
+#define VS_PLANES_NONE             \
+	{                          \
+		0, { { 0, 0, 0 } } \
+	}
+#define VS_PLANES_1(b0, w0, h0)       \
+	{                             \
+		1, { { b0, w0, h0 } } \
+	}
+#define VS_PLANES_2(b0, w0, h0, b1, w1, h1)           \
+	{                                             \
+		2, { { b0, w0, h0 }, { b1, w1, h1 } } \
+	}
+#define VS_PLANES_3(b0, w0, h0, b1, w1, h1, b2, w2, h2)               \
+	{                                                             \
+		3, { { b0, w0, h0 }, { b1, w1, h1 }, { b2, w2, h2 } } \
+	}
+/* layout of any format not described by the list */
+#define VS_PLANES_DEFAULT VS_PLANES_1(32, 1, 1)
+
+/*
+ * VS_FORMAT(format, class, standard, custom, dec400a)
+ *
+ * @format is the DRM_FORMAT_ suffix and @class the VS_FORMAT_CLASS_ suffix.
+ * Formats missing from the list use VS_FORMAT_CLASS_DEFAULT and
+ * VS_PLANES_DEFAULT, except for the custom variant which is unsupported.
+ */
+#define VS_FORMAT_LIST(VS_FORMAT)                                                                  \
+	VS_FORMAT(XRGB4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(XBGR4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(RGBX4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(BGRX4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(ARGB4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(ABGR4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(RGBA4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(BGRA4444, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(XRGB1555, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(XBGR1555, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(RGBX5551, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(BGRX5551, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(ARGB1555, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(ABGR1555, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(RGBA5551, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(BGRA5551, DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)     \
+	VS_FORMAT(RGB565, RGB565, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)        \
+	VS_FORMAT(BGR565, RGB565, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)        \
+	VS_FORMAT(YUYV, YUYV, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)            \
+	VS_FORMAT(UYVY, YUYV, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)            \
+	VS_FORMAT(YVYU, YUV, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)             \
+	VS_FORMAT(VYUY, YUV, VS_PLANES_1(16, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)             \
+	VS_FORMAT(RGB888, DEFAULT, VS_PLANES_1(24, 1, 1), VS_PLANES_3(8, 1, 1, 8, 1, 1, 8, 1, 1),  \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(BGR888, DEFAULT, VS_PLANES_1(24, 1, 1), VS_PLANES_3(8, 1, 1, 8, 1, 1, 8, 1, 1),  \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(ARGB16161616F, DEFAULT, VS_PLANES_1(64, 1, 1), VS_PLANES_NONE,                   \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(ABGR16161616F, DEFAULT, VS_PLANES_1(64, 1, 1), VS_PLANES_NONE,                   \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(XRGB16161616F, DEFAULT, VS_PLANES_1(64, 1, 1), VS_PLANES_NONE,                   \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(XBGR16161616F, DEFAULT, VS_PLANES_1(64, 1, 1), VS_PLANES_NONE,                   \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(NV12, NV12, VS_PLANES_2(8, 1, 1, 16, 2, 2), VS_PLANES_2(10, 1, 1, 20, 2, 2),     \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(NV21, NV12, VS_PLANES_2(8, 1, 1, 16, 2, 2), VS_PLANES_NONE, VS_PLANES_DEFAULT)   \
+	VS_FORMAT(NV16, YUV, VS_PLANES_2(8, 1, 1, 16, 2, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)    \
+	VS_FORMAT(NV61, YUV, VS_PLANES_2(8, 1, 1, 16, 2, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)    \
+	VS_FORMAT(P010, P010, VS_PLANES_2(16, 1, 1, 32, 2, 2), VS_PLANES_2(16, 1, 1, 32, 2, 2),    \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(P210, YUV, VS_PLANES_2(16, 1, 1, 32, 2, 1), VS_PLANES_2(16, 1, 1, 32, 2, 1),     \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(YUV420, YUV420, VS_PLANES_3(8, 1, 1, 8, 2, 2, 8, 2, 2),                          \
+		  VS_PLANES_3(16, 1, 1, 16, 2, 2, 16, 2, 2), VS_PLANES_DEFAULT)                    \
+	VS_FORMAT(YVU420, YUV420, VS_PLANES_3(8, 1, 1, 8, 2, 2, 8, 2, 2),                          \
+		  VS_PLANES_3(16, 1, 1, 16, 2, 2, 16, 2, 2), VS_PLANES_DEFAULT)                    \
+	VS_FORMAT(YUV444, YUV444, VS_PLANES_3(8, 1, 1, 8, 1, 1, 8, 1, 1),                          \
+		  VS_PLANES_3(10, 1, 1, 10, 1, 1, 10, 1, 1), VS_PLANES_DEFAULT)                    \
+	VS_FORMAT(YVU444, DEFAULT, VS_PLANES_3(8, 1, 1, 8, 1, 1, 8, 1, 1), VS_PLANES_NONE,         \
+		  VS_PLANES_DEFAULT)                                                               \
+	VS_FORMAT(C8, DEFAULT, VS_PLANES_1(8, 1, 1), VS_PLANES_NONE, VS_PLANES_DEFAULT)            \
+	VS_FORMAT(RGB565_A8, DEFAULT, VS_PLANES_DEFAULT, VS_PLANES_1(24, 1, 1), VS_PLANES_DEFAULT) \
+	VS_FORMAT(BGR565_A8, DEFAULT, VS_PLANES_DEFAULT, VS_PLANES_1(24, 1, 1), VS_PLANES_DEFAULT) \
+	VS_FORMAT(YUV420_10BIT, YUV, VS_PLANES_DEFAULT, VS_PLANES_2(32, 3, 1, 64, 6, 2),           \
+		  VS_PLANES_1(24, 1, 1))                                                           \
+	VS_FORMAT(P016, YUV, VS_PLANES_DEFAULT, VS_PLANES_2(32, 3, 1, 64, 6, 2),                   \
+		  VS_PLANES_DEFAULT)                                                               \
+	/* LUMA_10 */                                                                              \
+	VS_FORMAT(Y0L0, DEFAULT, VS_PLANES_DEFAULT, VS_PLANES_1(16, 1, 1), VS_PLANES_DEFAULT)      \
+	VS_FORMAT(YUV420_8BIT, DEFAULT, VS_PLANES_DEFAULT, VS_PLANES_NONE, VS_PLANES_1(12, 1, 1))
+
+/*
+ * VS_ALIGN(family, tile_mode, class, width_align, height_align)
+ *
+ * @family is the VS_MOD_FAMILY_ suffix, @tile_mode the DRM_FORMAT_MOD_VS_
+ * suffix and @class the VS_FORMAT_CLASS_ suffix. Alignment is in pixels
+ * and must be power of 2. The ANY rule of a tile mode comes first, class
+ * specific rules after it override it. Unlisted tile modes keep the input
+ * size. DEC400A and unknown modifier types follow the NORMAL rules.
+ */
+#define VS_ALIGN_LIST(VS_ALIGN)                                 \
+	/* dec400 sub-IP */                                     \
+	VS_ALIGN(DEC400, DEC_RASTER_32X1, ANY, 32, 1)           \
+	VS_ALIGN(DEC400, DEC_RASTER_64X1, ANY, 64, 1)           \
+	VS_ALIGN(DEC400, DEC_RASTER_128X1, ANY, 128, 1)         \
+	VS_ALIGN(DEC400, DEC_RASTER_256X1, ANY, 256, 1)         \
+	VS_ALIGN(DEC400, DEC_RASTER_256X1, YUV420, 512, 1)      \
+	VS_ALIGN(DEC400, DEC_TILE_8X4, ANY, 64, 64)             \
+	VS_ALIGN(DEC400, DEC_TILE_4X8, ANY, 64, 64)             \
+	VS_ALIGN(DEC400, DEC_TILE_8X4_UNIT2X2, ANY, 8, 4)       \
+	VS_ALIGN(DEC400, DEC_TILE_8X8_UNIT2X2, ANY, 8, 8)       \
+	VS_ALIGN(DEC400, DEC_TILE_8X8_XMAJOR, ANY, 64, 64)      \
+	VS_ALIGN(DEC400, DEC_TILE_8X8_XMAJOR, YUYV, 16, 8)      \
+	VS_ALIGN(DEC400, DEC_TILE_8X8_XMAJOR, P010, 16, 8)      \
+	VS_ALIGN(DEC400, DEC_TILE_16X8, ANY, 16, 8)             \
+	VS_ALIGN(DEC400, DEC_TILE_32X8, ANY, 16, 8)             \
+	VS_ALIGN(DEC400, DEC_TILE_8X8_SUPERTILE_X, ANY, 64, 64) \
+	VS_ALIGN(DEC400, DEC_TILE_32X8_YUVSP8X8, ANY, 32, 8)    \
+	VS_ALIGN(DEC400, DEC_TILE_16X8_YUVSP8X8, ANY, 16, 8)    \
+	/* PVRIC sub-IP */                                      \
+	VS_ALIGN(PVRIC, DEC_TILE_8X8, ANY, 32, 8)               \
+	VS_ALIGN(PVRIC, DEC_TILE_8X8, P010, 16, 8)              \
+	VS_ALIGN(PVRIC, DEC_TILE_16X4, ANY, 16, 4)              \
+	VS_ALIGN(PVRIC, DEC_TILE_16X4, RGB565, 32, 4)           \
+	VS_ALIGN(PVRIC, DEC_TILE_32X2, ANY, 32, 2)              \
+	/* DECNano sub-IP */                                    \
+	VS_ALIGN(DECNANO, DEC_LINEAR, ANY, 16, 1)               \
+	VS_ALIGN(DECNANO, DEC_TILE_4X4, ANY, 16, 4)             \
+	/* ETC2 sub-IP */                                       \
+	VS_ALIGN(ETC2, DEC_TILE_4X4, ANY, 16, 4)                \
+	/* normal tile modes */                                 \
+	VS_ALIGN(NORMAL, LINEAR, YUV, 2, 2)                     \
+	VS_ALIGN(NORMAL, LINEAR, YUYV, 2, 2)                    \
+	VS_ALIGN(NORMAL, LINEAR, P010, 2, 2)                    \
+	VS_ALIGN(NORMAL, LINEAR, NV12, 2, 2)                    \
+	VS_ALIGN(NORMAL, LINEAR, YUV420, 2, 2)                  \
+	VS_ALIGN(NORMAL, TILE_8X8, ANY, 8, 8)                   \
+	VS_ALIGN(NORMAL, TILE_8X8_UNIT2X2, ANY, 8, 8)           \
+	VS_ALIGN(NORMAL, TILE_8X4, ANY, 8, 4)                   \
+	VS_ALIGN(NORMAL, TILE_8X4_UNIT2X2, ANY, 8, 4)           \
+	VS_ALIGN(NORMAL, SUPER_TILED_XMAJOR, ANY, 64, 64)       \
+	VS_ALIGN(NORMAL, SUPER_TILED_XMAJOR_8X4, ANY, 64, 64)   \
+	VS_ALIGN(NORMAL, SUPER_TILED_YMAJOR_4X8, ANY, 64, 64)   \
+	VS_ALIGN(NORMAL, TILE_MODE4X4, NV12, 64, 4)             \
+	VS_ALIGN(NORMAL, TILE_MODE4X4, YUV444, 32, 4)           \
+	VS_ALIGN(NORMAL, TILE_32X8, ANY, 32, 8)                 \
+	VS_ALIGN(NORMAL, TILE_32X8_A, ANY, 32, 8)               \
+	VS_ALIGN(NORMAL, TILE_16X16, ANY, 16, 16)               \
+	VS_ALIGN(NORMAL, TILE_16X4, ANY, 16, 4)                 \
+	VS_ALIGN(NORMAL, TILE_8X8_SUPERTILE_X, ANY, 64, 64)     \
+	VS_ALIGN(NORMAL, TILE_32X8_YUVSP8X8, ANY, 32, 8)        \
+	VS_ALIGN(NORMAL, TILE_16X8_YUVSP8X8, ANY, 16, 8)
+
+/*
+ * VS_TILE_HEIGHT(family, tile_mode, class, planes, h0, h1, h2)
+ *
+ * Tile height of the first @planes planes, naming as for VS_ALIGN.
+ * The NORMAL family is indexed with DRM_FORMAT_MOD_VS_NORM_MODE_MASK,
+ * the others with DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK.
+ */
+#define VS_TILE_HEIGHT_LIST(VS_TILE_HEIGHT)                              \
+	VS_TILE_HEIGHT(NORMAL, LINEAR, ANY, 3, 1, 1, 1)                  \
+	VS_TILE_HEIGHT(NORMAL, TILE_16X4, ANY, 3, 4, 4, 4)               \
+	VS_TILE_HEIGHT(NORMAL, TILE_16X8_YUVSP8X8, P010, 2, 8, 4, 0)     \
+	VS_TILE_HEIGHT(NORMAL, TILE_32X8_YUVSP8X8, NV12, 2, 8, 4, 0)     \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_16X1, ANY, 3, 1, 1, 1)         \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_32X1, ANY, 3, 1, 1, 1)         \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_64X1, ANY, 3, 1, 1, 1)         \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_128X1, ANY, 3, 1, 1, 1)        \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_256X1, ANY, 3, 1, 1, 1)        \
+	VS_TILE_HEIGHT(DEC400, DEC_RASTER_512X1, ANY, 3, 1, 1, 1)        \
+	VS_TILE_HEIGHT(DEC400, DEC_TILE_16X8_YUVSP8X8, P010, 2, 8, 4, 0) \
+	VS_TILE_HEIGHT(DEC400, DEC_TILE_32X8_YUVSP8X8, NV12, 2, 8, 4, 0) \
+	VS_TILE_HEIGHT(DEC400, DEC_TILE_8X8_SUPERTILE_X, ANY, 1, 64, 0, 0)
+
+/*
+ * VS_DEC_TILE(tile_mode, pixels)
+ *
+ * Number of pixels in one dec400 tile, the tile size in bytes
+ * is pixels * bpp / 8. Unlisted tile modes have no tile size.
+ */
+#define VS_DEC_TILE_LIST(VS_DEC_TILE)             \
+	VS_DEC_TILE(DEC_RASTER_16X1, 16)          \
+	VS_DEC_TILE(DEC_TILE_8X4, 32)             \
+	VS_DEC_TILE(DEC_TILE_4X8, 32)             \
+	VS_DEC_TILE(DEC_RASTER_32X1, 32)          \
+	VS_DEC_TILE(DEC_TILE_8X4_S, 32)           \
+	VS_DEC_TILE(DEC_TILE_8X4_UNIT2X2, 32)     \
+	VS_DEC_TILE(DEC_TILE_8X8_XMAJOR, 64)      \
+	VS_DEC_TILE(DEC_TILE_8X8_YMAJOR, 64)      \
+	VS_DEC_TILE(DEC_TILE_8X8_UNIT2X2, 64)     \
+	VS_DEC_TILE(DEC_TILE_8X8_SUPERTILE_X, 64) \
+	VS_DEC_TILE(DEC_TILE_16X4, 64)            \
+	VS_DEC_TILE(DEC_RASTER_16X4, 64)          \
+	VS_DEC_TILE(DEC_RASTER_64X1, 64)          \
+	VS_DEC_TILE(DEC_RASTER_32X2, 64)          \
+	VS_DEC_TILE(DEC_TILE_16X4_S, 64)          \
+	VS_DEC_TILE(DEC_TILE_16X4_LSB, 64)        \
+	VS_DEC_TILE(DEC_TILE_16X4_YUVSP8X8, 64)   \
+	VS_DEC_TILE(DEC_TILE_32X4, 128)           \
+	VS_DEC_TILE(DEC_RASTER_128X1, 128)        \
+	VS_DEC_TILE(DEC_TILE_16X8, 128)           \
+	VS_DEC_TILE(DEC_TILE_8X16, 128)           \
+	VS_DEC_TILE(DEC_RASTER_32X4, 128)         \
+	VS_DEC_TILE(DEC_RASTER_64X2, 128)         \
+	VS_DEC_TILE(DEC_TILE_32X4_S, 128)         \
+	VS_DEC_TILE(DEC_TILE_32X4_LSB, 128)       \
+	VS_DEC_TILE(DEC_TILE_32X4_YUVSP8X8, 128)  \
+	VS_DEC_TILE(DEC_TILE_16X8_YUVSP8X8, 128)  \
+	VS_DEC_TILE(DEC_TILE_64X4, 256)           \
+	VS_DEC_TILE(DEC_RASTER_256X1, 256)        \
+	VS_DEC_TILE(DEC_RASTER_64X4, 256)         \
+	VS_DEC_TILE(DEC_RASTER_128X2, 256)        \
+	VS_DEC_TILE(DEC_TILE_16X16, 256)          \
+	VS_DEC_TILE(DEC_TILE_32X8, 256)           \
+	VS_DEC_TILE(DEC_TILE_32X8_YUVSP8X8, 256)  \
+	VS_DEC_TILE(DEC_RASTER_256X2, 512)        \
+	VS_DEC_TILE(DEC_RASTER_128X4, 512)        \
+	VS_DEC_TILE(DEC_RASTER_512X1, 512)        \
+	VS_DEC_TILE(DEC_TILE_128X4, 512)          \
+	VS_DEC_TILE(DEC_TILE_32X16, 512)          \
+	VS_DEC_TILE(DEC_TILE_256X4, 1024)         \
+	VS_DEC_TILE(DEC_TILE_64X16, 1024)         \
+	VS_DEC_TILE(DEC_TILE_128X8, 1024)         \
+	VS_DEC_TILE(DEC_TILE_512X4, 2048)
+
+/*
+ * VS_PVRIC_TILE(tile_mode, height)
+ *
+ * Height of one PVRIC tile, unlisted tile modes are 1 line high.
+ */
+#define VS_PVRIC_TILE_LIST(VS_PVRIC_TILE) \
+	VS_PVRIC_TILE(DEC_TILE_8X8, 8)    \
+	VS_PVRIC_TILE(DEC_TILE_16X4, 4)   \
+	VS_PVRIC_TILE(DEC_TILE_32X2, 2)
+
+/*
+ * VS_DEC_TS_8BIT(tile_mode)
+ *
+ * DEC400 tile modes with 8 bits of tile status per 256 bytes of data, the
+ * DRM_FORMAT_MOD_VS_ suffix. Unlisted tile modes have 4 bits per 256 bytes,
+ * or per 128 bytes for 128 byte tiles.
+ */
+#define VS_DEC_TS_8BIT_LIST(VS_DEC_TS_8BIT) \
+	VS_DEC_TS_8BIT(DEC_TILE_8X8_UNIT2X2) \
+	VS_DEC_TS_8BIT(DEC_TILE_8X4_UNIT2X2)
+
+/* tile status bytes of @area data bytes in @tile_size byte DEC400 tiles */
+#define VS_DEC_TS_SIZE(area, tile_size, ts_8bit)   \
+	((ts_8bit) ? ((area) + 255) / 256 :        \
+		     ((area) + 511) / 512 << ((tile_size) == 128 ? 1 : 0))
+
+/* fast clear area after the DEC400 tile status, @fc_size from the modifier */
+#define VS_DEC_FC_SIZE(fc_size) (128 + 128 * (uint64_t)(fc_size))
+
+/*
+ * VS_DEC400A_SUPERBLOCK(format, sb_w, sb_h)
+ *
+ * Superblock in pixels of DEC400A formats, the DRM_FORMAT_ suffix.
+ * Unlisted formats use VS_DEC400A_SUPERBLOCK_W x VS_DEC400A_SUPERBLOCK_H.
+ * Each superblock has a VS_DEC400A_HEADER_SIZE bytes header.
+ */
+#define VS_DEC400A_SUPERBLOCK_LIST(VS_DEC400A_SUPERBLOCK) \
+	VS_DEC400A_SUPERBLOCK(ARGB8888, 32, 8)            \
+	VS_DEC400A_SUPERBLOCK(ARGB2101010, 32, 8)         \
+	VS_DEC400A_SUPERBLOCK(YUV420_8BIT, 32, 8)         \
+	VS_DEC400A_SUPERBLOCK(YUV420_10BIT, 32, 8)
+
+#define VS_DEC400A_SUPERBLOCK_W 16
+#define VS_DEC400A_SUPERBLOCK_H 16
+#define VS_DEC400A_HEADER_SIZE 16
+
+/* header bytes of a @width x @height DEC400A plane */
+#define VS_DEC400A_TS_SIZE(width, height, sb_w, sb_h)                                 \
+	(((uint64_t)(width) + (sb_w) - 1) / (sb_w) * (((uint64_t)(height) + (sb_h) - 1) / \
+						      (sb_h)) * VS_DEC400A_HEADER_SIZE)
+
+/*
+ * VS_PVRIC_LOSSY(format, bytes)
+ *
+ * Bytes of one 256 bytes PVRIC tile with DRM_FORMAT_MOD_VS_DEC_LOSSY, the
+ * DRM_FORMAT_ suffix. Unlisted formats use VS_PVRIC_LOSSY_BYTES.
+ */
+#define VS_PVRIC_LOSSY_LIST(VS_PVRIC_LOSSY) VS_PVRIC_LOSSY(P010, 96)
+
+#define VS_PVRIC_LOSSY_BYTES 128
+
+/*
+ * VS_TILE_GEOMETRY(family, tile_mode, tile_w, tile_h)
+ *
+ * Tile width and height in pixels of each tile mode, naming as for VS_ALIGN.
+ * Every plane is tiled on its own, with the modifier vs_mod_config gives it.
+ * Linear modes are 1x1. DEC400A tiles are the superblocks of the format,
+ * DECNano and ETC2 tiles the blocks of VS_BLOCK_LIST.
+ */
+#define VS_TILE_GEOMETRY_LIST(VS_TILE_GEOMETRY)                    \
+	/* normal tile modes */                                    \
+	VS_TILE_GEOMETRY(NORMAL, LINEAR, 1, 1)                     \
+	VS_TILE_GEOMETRY(NORMAL, TILE_8X8, 8, 8)                   \
+	VS_TILE_GEOMETRY(NORMAL, TILE_8X4, 8, 4)                   \
+	VS_TILE_GEOMETRY(NORMAL, SUPER_TILED_XMAJOR, 64, 64)       \
+	VS_TILE_GEOMETRY(NORMAL, SUPER_TILED_XMAJOR_8X4, 64, 64)   \
+	VS_TILE_GEOMETRY(NORMAL, SUPER_TILED_YMAJOR_4X8, 64, 64)   \
+	VS_TILE_GEOMETRY(NORMAL, TILE_MODE4X4, 4, 4)               \
+	VS_TILE_GEOMETRY(NORMAL, TILE_32X8, 32, 8)                 \
+	VS_TILE_GEOMETRY(NORMAL, TILE_32X8_A, 32, 8)               \
+	VS_TILE_GEOMETRY(NORMAL, TILE_16X16, 16, 16)               \
+	VS_TILE_GEOMETRY(NORMAL, TILE_16X4, 16, 4)                 \
+	VS_TILE_GEOMETRY(NORMAL, TILE_8X8_SUPERTILE_X, 64, 64)     \
+	VS_TILE_GEOMETRY(NORMAL, TILE_32X8_YUVSP8X8, 32, 8)        \
+	VS_TILE_GEOMETRY(NORMAL, TILE_16X8_YUVSP8X8, 16, 8)        \
+	VS_TILE_GEOMETRY(NORMAL, TILE_8X8_UNIT2X2, 8, 8)           \
+	VS_TILE_GEOMETRY(NORMAL, TILE_8X4_UNIT2X2, 8, 4)           \
+	/* dec400 sub-IP */                                        \
+	VS_TILE_GEOMETRY(DEC400, DEC_LINEAR, 1, 1)                 \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X8_XMAJOR, 8, 8)        \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X8_YMAJOR, 8, 8)        \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X4, 16, 4)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X4, 8, 4)               \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_4X8, 4, 8)               \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_16X4, 16, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_64X4, 64, 4)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X4, 32, 4)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_256X1, 256, 1)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_128X1, 128, 1)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_64X4, 64, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_256X2, 256, 2)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_128X2, 128, 2)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_128X4, 128, 4)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_64X1, 64, 1)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X8, 16, 8)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X16, 8, 16)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_512X1, 512, 1)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_32X4, 32, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_64X2, 64, 2)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_32X2, 32, 2)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_32X1, 32, 1)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_RASTER_16X1, 16, 1)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_128X4, 128, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_256X4, 256, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_512X4, 512, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X16, 16, 16)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X16, 32, 16)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_64X16, 64, 16)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_128X8, 128, 8)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X4_S, 8, 4)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X4_S, 16, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X4_S, 32, 4)           \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X4_LSB, 16, 4)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X4_LSB, 32, 4)         \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X8, 32, 8)             \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X8_UNIT2X2, 8, 8)       \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X4_UNIT2X2, 8, 4)       \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_8X8_SUPERTILE_X, 64, 64) \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X8_YUVSP8X8, 32, 8)    \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X8_YUVSP8X8, 16, 8)    \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_32X4_YUVSP8X8, 32, 4)    \
+	VS_TILE_GEOMETRY(DEC400, DEC_TILE_16X4_YUVSP8X8, 16, 4)    \
+	/* PVRIC sub-IP */                                         \
+	VS_TILE_GEOMETRY(PVRIC, DEC_TILE_8X8, 8, 8)                \
+	VS_TILE_GEOMETRY(PVRIC, DEC_TILE_16X4, 16, 4)              \
+	VS_TILE_GEOMETRY(PVRIC, DEC_TILE_32X2, 32, 2)
+
+/*
+ * VS_FETCH_ORDER(family, tile_mode, tile_w, tile_h, y_major, group)
+ *
+ * Memory order of tile modes whose tiles are not simply stored row by row,
+ * naming as for VS_ALIGN. Tiles of @tile_w x @tile_h pixels are stored in
+ * runs of @group tiles going down (@y_major) or across, e.g. the inner
+ * tiles of a 64x64 super tile. Unlisted tile modes store the tiles of
+ * VS_TILE_GEOMETRY_LIST across the whole row.
+ */
+#define VS_FETCH_ORDER_LIST(VS_FETCH_ORDER)                            \
+	VS_FETCH_ORDER(NORMAL, SUPER_TILED_XMAJOR, 8, 8, 0, 8)         \
+	VS_FETCH_ORDER(NORMAL, SUPER_TILED_XMAJOR_8X4, 8, 4, 0, 8)     \
+	VS_FETCH_ORDER(NORMAL, SUPER_TILED_YMAJOR_4X8, 4, 8, 1, 8)     \
+	VS_FETCH_ORDER(NORMAL, TILE_8X8_SUPERTILE_X, 8, 8, 0, 8)       \
+	VS_FETCH_ORDER(DEC400, DEC_TILE_8X8_YMAJOR, 8, 8, 1, 2)        \
+	VS_FETCH_ORDER(DEC400, DEC_TILE_8X8_SUPERTILE_X, 8, 8, 0, 8)
+
+/*
+ * VS_BLOCK(family, tile_mode, block_w, block_h, ratio)
+ *
+ * Fixed rate compressed blocks of DECNano and ETC2, naming as for VS_ALIGN.
+ * One block of @block_w x @block_h pixels of a plane of bpp bits takes
+ * block_w * block_h * bpp / 8 / @ratio bytes, or the bytes of the format in
+ * VS_ETC2_FORMAT_LIST if @ratio is 0. These sub-IPs have neither header nor
+ * tile status buffer.
+ */
+#define VS_BLOCK_LIST(VS_BLOCK)                  \
+	/* DECNano, 2:1 */                       \
+	VS_BLOCK(DECNANO, DEC_LINEAR, 16, 1, 2)  \
+	VS_BLOCK(DECNANO, DEC_TILE_4X4, 4, 4, 2) \
+	/* ETC2, per format */                   \
+	VS_BLOCK(ETC2, DEC_TILE_4X4, 4, 4, 0)
+
+/*
+ * VS_ETC2_FORMAT(format, bytes)
+ *
+ * RGB formats ETC2 compresses and the bytes of one of their blocks, 8 for
+ * RGB8 and 16 for RGBA8 with EAC alpha. Other formats are sized as
+ * uncompressed with ETC2 modifiers and left out of drm_vs_negotiate_mod.
+ */
+#define VS_ETC2_FORMAT_LIST(VS_ETC2_FORMAT) \
+	VS_ETC2_FORMAT(RGB888, 8)           \
+	VS_ETC2_FORMAT(BGR888, 8)           \
+	VS_ETC2_FORMAT(XRGB8888, 8)         \
+	VS_ETC2_FORMAT(XBGR8888, 8)         \
+	VS_ETC2_FORMAT(RGBX8888, 8)         \
+	VS_ETC2_FORMAT(BGRX8888, 8)         \
+	VS_ETC2_FORMAT(ARGB8888, 16)        \
+	VS_ETC2_FORMAT(ABGR8888, 16)        \
+	VS_ETC2_FORMAT(RGBA8888, 16)        \
+	VS_ETC2_FORMAT(BGRA8888, 16)
+
+/*
+ * VS_CHROMA_MOD(format, tile_mode, chroma_tile_mode)
+ *
+ * Tile mode of the chroma plane of DEC400 compressed semi-planar formats,
+ * both DRM_FORMAT_MOD_VS_ suffixes. The chroma modifier is coded with
+ * DRM_FORMAT_MOD_VS_DEC_ALIGN_32. A listed format is unsupported with
+ * the DEC400 tile modes missing here, unlisted formats use the same
+ * modifier for every plane.
+ */
+#define VS_CHROMA_MOD_LIST(VS_CHROMA_MOD)                                   \
+	VS_CHROMA_MOD(NV12, DEC_RASTER_256X1, DEC_RASTER_128X1)             \
+	VS_CHROMA_MOD(NV12, DEC_RASTER_128X1, DEC_RASTER_64X1)              \
+	VS_CHROMA_MOD(NV12, DEC_TILE_32X8, DEC_TILE_32X4)                   \
+	VS_CHROMA_MOD(NV12, DEC_TILE_16X8, DEC_TILE_16X4)                   \
+	VS_CHROMA_MOD(NV12, DEC_TILE_32X8_YUVSP8X8, DEC_TILE_32X4_YUVSP8X8) \
+	VS_CHROMA_MOD(NV21, DEC_RASTER_256X1, DEC_RASTER_128X1)             \
+	VS_CHROMA_MOD(NV21, DEC_RASTER_128X1, DEC_RASTER_64X1)              \
+	VS_CHROMA_MOD(NV21, DEC_TILE_32X8, DEC_TILE_32X4)                   \
+	VS_CHROMA_MOD(NV21, DEC_TILE_16X8, DEC_TILE_16X4)                   \
+	VS_CHROMA_MOD(NV21, DEC_TILE_32X8_YUVSP8X8, DEC_TILE_32X4_YUVSP8X8) \
+	VS_CHROMA_MOD(P010, DEC_RASTER_128X1, DEC_RASTER_64X1)              \
+	VS_CHROMA_MOD(P010, DEC_RASTER_64X1, DEC_RASTER_32X1)               \
+	VS_CHROMA_MOD(P010, DEC_TILE_16X8, DEC_TILE_16X4)                   \
+	VS_CHROMA_MOD(P010, DEC_TILE_8X8_XMAJOR, DEC_TILE_8X4)              \
+	VS_CHROMA_MOD(P010, DEC_TILE_16X8_YUVSP8X8, DEC_TILE_16X4_YUVSP8X8) \
+	VS_CHROMA_MOD(P210, DEC_RASTER_128X1, DEC_RASTER_64X1)              \
+	VS_CHROMA_MOD(P210, DEC_RASTER_64X1, DEC_RASTER_32X1)               \
+	VS_CHROMA_MOD(P210, DEC_TILE_16X8, DEC_TILE_16X4)                   \
+	VS_CHROMA_MOD(P210, DEC_TILE_8X8_XMAJOR, DEC_TILE_8X4)              \
+	VS_CHROMA_MOD(P210, DEC_TILE_16X8_YUVSP8X8, DEC_TILE_16X4_YUVSP8X8) \
+	VS_CHROMA_MOD(NV16, DEC_RASTER_256X1, DEC_RASTER_128X1)             \
+	VS_CHROMA_MOD(NV16, DEC_RASTER_128X1, DEC_RASTER_64X1)              \
+	VS_CHROMA_MOD(NV61, DEC_RASTER_256X1, DEC_RASTER_128X1)             \
+	VS_CHROMA_MOD(NV61, DEC_RASTER_128X1, DEC_RASTER_64X1)
+
+#endif /* __VS_BO_FORMAT_DEF_H__ */
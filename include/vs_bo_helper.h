@@ -52,6 +52,225 @@ typedef struct drm_vs_bo_param {
 	uint32_t ts_buf_size;
 } drm_vs_bo_param;
 
+/* largest surface, in pixels, supported by the 64-bit layout path */
+#define VS_MAX_SURFACE_SIZE 16384
+
+/* drm_vs_bo_param with sizes that may not fit in 32 bits */
+typedef struct drm_vs_bo_param64 {
+	uint32_t width;
+	uint64_t height;
+	uint8_t bpp;
+
+	/* bytes per row and size of the plane, tile status/header included */
+	uint64_t pitch;
+	uint64_t size;
+
+	/* header resource size of PVRIC */
+	uint64_t header_size;
+	/* tile status buffer size of DEC400 */
+	uint64_t ts_buf_size;
+} drm_vs_bo_param64;
+
+typedef struct drm_vs_format_desc {
+	uint32_t num_planes;
+	uint8_t bpp[4];
+	/* width and height divisor of each plane */
+	uint8_t hsub[4];
+	uint8_t vsub[4];
+
+	/* width and height alignment in pixels */
+	uint32_t align_width;
+	uint32_t align_height;
+	/* tile height of each plane, 0 if not defined */
+	uint8_t tile_height[4];
+} drm_vs_format_desc;
+
+typedef struct drm_vs_tile_geometry {
+	uint32_t num_planes;
+	/* tile width and height in pixels of each plane, 0 if unknown */
+	uint16_t width[4];
+	uint16_t height[4];
+	/* bytes of one tile of each plane, compressed size for DECNano/ETC2 */
+	uint32_t bytes[4];
+	/*
+	 * tiles inside a super tile and their order, going down first if
+	 * y_major, inner tile equals the tile for other tile modes
+	 */
+	uint16_t inner_width[4];
+	uint16_t inner_height[4];
+	uint8_t y_major[4];
+} drm_vs_tile_geometry;
+
+typedef struct drm_vs_bo_cache_stats {
+	uint64_t hits;
+	uint64_t misses;
+} drm_vs_bo_cache_stats;
+
+typedef struct drm_vs_bo_request {
+	/* unaligned width and height */
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint64_t mod;
+} drm_vs_bo_request;
+
+typedef struct drm_vs_bo_result {
+	/* 0 on success, error of drm_vs_bo_config otherwise */
+	int ret;
+	/* width and height aligned by drm_vs_get_align_size */
+	uint32_t width;
+	uint32_t height;
+
+	uint32_t num_planes;
+	drm_vs_bo_param bo_param[4];
+	uint64_t modifiers[4];
+} drm_vs_bo_result;
+
+typedef struct drm_vs_bo_layout {
+	uint32_t num_planes;
+	/* total size of the buffer holding all planes */
+	uint64_t size;
+
+	/* byte offset and pitch of the data of each plane */
+	uint64_t offsets[4];
+	uint32_t pitches[4];
+	/* bytes used by each plane, tile status/header included */
+	uint64_t plane_size[4];
+
+	/* byte offset and size of DEC400 tile status or PVRIC header, 0 if none */
+	uint64_t ts_offsets[4];
+	uint64_t ts_size[4];
+
+	uint64_t modifiers[4];
+
+	/* parameters of the single DRM_IOCTL_MODE_CREATE_DUMB */
+	drm_vs_bo_param dumb;
+} drm_vs_bo_layout;
+
+/* page sizes of drm_vs_get_bo_layout_paged */
+#define VS_PAGE_SIZE_4K (4ull << 10)
+#define VS_PAGE_SIZE_64K (64ull << 10)
+#define VS_PAGE_SIZE_2M (2ull << 20)
+
+typedef struct drm_vs_page_cost {
+	uint64_t page_size;
+	/* buffer size of drm_vs_get_bo_layout and with page alignment */
+	uint64_t base_size;
+	uint64_t size;
+	/*
+	 * IOMMU TLB entries mapping the whole buffer, with 4KB pages for the
+	 * drm_vs_get_bo_layout buffer and with page_size pages for the aligned one
+	 */
+	uint64_t base_tlb_entries;
+	uint64_t tlb_entries;
+} drm_vs_page_cost;
+
+/* most display pipes driving one surface */
+#define VS_MAX_SPLIT_PIPES 4
+
+/* part of a surface fetched by one pipe */
+typedef struct drm_vs_split_pipe {
+	/* first surface column and number of columns */
+	uint32_t x;
+	uint32_t width;
+
+	/* byte offset of the first column of each plane in the buffer */
+	uint64_t offsets[4];
+	/* byte offset of its tile status or PVRIC header, if ts_pitches[i] is not 0 */
+	uint64_t ts_offsets[4];
+} drm_vs_split_pipe;
+
+typedef struct drm_vs_split_layout {
+	uint32_t num_pipes;
+	/* split points are multiples of this many surface columns */
+	uint32_t align;
+	/* the whole surface, see drm_vs_get_bo_layout */
+	drm_vs_bo_layout layout;
+	/* bytes between tile status/header of two tile rows, 0 if none */
+	uint64_t ts_pitches[4];
+
+	drm_vs_split_pipe pipes[VS_MAX_SPLIT_PIPES];
+} drm_vs_split_layout;
+
+/* scanout rotation, counter-clockwise in degrees */
+#define VS_ROTATION_0 0
+#define VS_ROTATION_90 90
+#define VS_ROTATION_180 180
+#define VS_ROTATION_270 270
+
+/* contiguous bytes the display needs in one fetch to run at full burst rate */
+#define VS_FETCH_BURST_SIZE 256
+
+typedef struct drm_vs_rotated_layout {
+	/* modifier with the chosen tile mode, aligned width and height */
+	uint64_t mod;
+	uint32_t width;
+	uint32_t height;
+	drm_vs_bo_param bo_param[4];
+	drm_vs_bo_layout layout;
+
+	/* lines fetched at once, across the scan */
+	uint32_t line_depth;
+	/* contiguous bytes of one fetch along the scan, of the worst plane */
+	uint32_t burst_bytes;
+	/* burst_bytes in percent of VS_FETCH_BURST_SIZE, 100 at most */
+	uint32_t efficiency;
+} drm_vs_rotated_layout;
+
+/* most dirty rectangles drm_vs_map_damage returns */
+#define VS_MAX_DAMAGE_RECTS 16
+
+/* byte range of the buffer laid out by drm_vs_get_bo_layout */
+typedef struct drm_vs_byte_range {
+	uint64_t offset;
+	uint64_t size;
+} drm_vs_byte_range;
+
+typedef struct drm_vs_damage_map {
+	/* tile aligned and coalesced damage */
+	uint32_t num_rects;
+	struct drm_vs_rect rects[VS_MAX_DAMAGE_RECTS];
+
+	/*
+	 * Arrays of max_data and max_ts entries provided by the caller, filled
+	 * with sorted, disjoint ranges of plane data and of DEC400/DEC400A tile
+	 * status and PVRIC header. Close ranges are merged to fit, 0 entries
+	 * skip the ranges of that kind.
+	 */
+	drm_vs_byte_range *data;
+	uint32_t max_data;
+	uint32_t num_data;
+	drm_vs_byte_range *ts;
+	uint32_t max_ts;
+	uint32_t num_ts;
+
+	/* bytes covered by the data and ts ranges */
+	uint64_t data_bytes;
+	uint64_t ts_bytes;
+} drm_vs_damage_map;
+
+typedef struct drm_vs_mod_cost_model {
+	/* scanout rotation, VS_ROTATION_* */
+	uint32_t rotation;
+	/* expected size of lossless compressed data, percent of uncompressed */
+	uint32_t compress_ratio;
+	/* cost of one allocated byte and of one byte fetched per frame */
+	uint32_t size_weight;
+	uint32_t fetch_weight;
+	/* nonzero to rank lossy modifiers: DEC_LOSSY, DECNano and ETC2 */
+	uint32_t allow_lossy;
+} drm_vs_mod_cost_model;
+
+typedef struct drm_vs_mod_rank {
+	uint64_t mod;
+	/* bytes of the single buffer object, see drm_vs_get_bo_layout */
+	uint64_t size;
+	/* estimated bytes fetched per frame */
+	uint64_t fetch_bytes;
+	/* size * size_weight + fetch_bytes * fetch_weight */
+	uint64_t cost;
+} drm_vs_mod_rank;
+
 typedef enum _vs_display_size_type {
 	VS_DISPLAY_640_480_60,
 	VS_DISPLAY_720_1612_60,
@@ -83,6 +302,103 @@ typedef enum _vs_display_id {
 	VS_DISPLAY_COUNT,
 } vs_display_id;
 
+/* one plane of a display in a frame memory plan */
+typedef struct drm_vs_plan_plane {
+	/* unaligned size, 0x0 for the size of the display mode */
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint64_t mod;
+	/* buffers allocated for the plane, e.g. 3 for triple buffering */
+	uint32_t num_buffers;
+
+	/* filled by drm_vs_plan_frame_memory */
+	/* bytes of one buffer, all format planes, tile status/header included */
+	uint64_t buffer_size;
+	/* DEC400/DEC400A tile status and PVRIC header bytes of one buffer */
+	uint64_t overhead;
+	/* buffer_size * num_buffers */
+	uint64_t total_size;
+} drm_vs_plan_plane;
+
+typedef struct drm_vs_plan_display {
+	vs_display_size_type mode;
+	uint32_t num_planes;
+	drm_vs_plan_plane *planes;
+
+	/* filled by drm_vs_plan_frame_memory, sum of the planes total_size */
+	uint64_t total_size;
+} drm_vs_plan_display;
+
+/* one plane of a display in a bandwidth estimate */
+typedef struct drm_vs_bw_plane {
+	/* unaligned source size, 0x0 for the size of the display mode */
+	uint32_t src_w;
+	uint32_t src_h;
+	/* size on the display, 0x0 for the source size */
+	uint32_t dst_w;
+	uint32_t dst_h;
+	uint32_t format;
+	uint64_t mod;
+
+	/* filled by drm_vs_estimate_bandwidth, in bytes per second */
+	/* average read bandwidth, tile status/header included */
+	uint64_t bandwidth;
+	/* read bandwidth while the lines of the plane scan out */
+	uint64_t peak_bandwidth;
+	/* DEC400/DEC400A tile status and PVRIC header part of bandwidth */
+	uint64_t ts_bandwidth;
+} drm_vs_bw_plane;
+
+typedef struct drm_vs_bw_display {
+	vs_display_size_type mode;
+	uint32_t num_planes;
+	drm_vs_bw_plane *planes;
+
+	/* filled by drm_vs_estimate_bandwidth */
+	uint32_t refresh;
+	/* sums of the planes bandwidth and peak_bandwidth */
+	uint64_t bandwidth;
+	uint64_t peak_bandwidth;
+} drm_vs_bw_display;
+
+/* fetch and scaler limits of one display for drm_vs_admit_planes */
+typedef struct drm_vs_dpu_limits {
+	/* bytes per second the display may read, at peak */
+	uint64_t fetch_bandwidth;
+	/* largest source to destination ratio, 16.16 as drm_vs_get_stretch_factor */
+	uint32_t max_downscale;
+	/* largest destination to source ratio, 16.16 */
+	uint32_t max_upscale;
+	/* bytes of vertical scaler line buffer of one plane */
+	uint32_t line_buffer_size;
+	/* expected size of lossless compressed data, percent of uncompressed */
+	uint32_t compress_ratio;
+} drm_vs_dpu_limits;
+
+/* one plane of a proposed commit */
+typedef struct drm_vs_admit_plane {
+	uint32_t format;
+	uint64_t mod;
+	/* source rectangle in the frame buffer and destination on the display */
+	struct drm_vs_rect src;
+	struct drm_vs_rect dst;
+	enum drm_vs_filter_type filter;
+	/* VS_ROTATION_* */
+	uint32_t rotation;
+
+	/* filled by drm_vs_admit_planes */
+	/* peak read bandwidth in bytes per second, see drm_vs_estimate_bandwidth */
+	uint64_t bandwidth;
+	/* 16.16 source to destination ratios */
+	uint32_t scale_h;
+	uint32_t scale_v;
+	/* bytes of vertical scaler line buffer needed */
+	uint32_t line_buffer;
+	/* 0 if the plane alone fits, -ERANGE for its scaler limits, -EINVAL */
+	int status;
+} drm_vs_admit_plane;
+
 typedef enum _vs_status {
 	VS_STATUS_FAILED = -2,
 	VS_STATUS_INVALID_ARGUMENTS = -1,
@@ -130,6 +446,21 @@ uint16_t vs_get_dec_tile_size(uint8_t tile_mode, uint8_t bpp);
  */
 void drm_vs_get_tile_height(uint32_t format, uint64_t mod, int *height);
 
+/*
+ * Get tile width, height and size of each plane accoring to
+ * input format and modifier, planes indexed as bo_param of
+ * drm_vs_bo_config. Linear modes have 1x1 tiles.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @geometry: pointer to the tile geometry to fill.
+ *
+ * Return 0 on success, -EINVAL if the format is unsupported with @mod.
+ */
+int drm_vs_get_tile_geometry(uint32_t format, uint64_t mod, drm_vs_tile_geometry *geometry);
+
 /*
  * Get aligned width and height accoring to
  * input format and tile mode/dec tile mode.
@@ -144,9 +475,25 @@ void drm_vs_get_tile_height(uint32_t format, uint64_t mod, int *height);
  */
 int drm_vs_get_align_size(uint32_t *width, uint32_t *height, uint32_t format, uint64_t mod);
 
+/*
+ * Get the precomputed layout descriptor of a format/modifier pair.
+ * Plane count, bpp and subsampling are the ones used by drm_vs_bo_config,
+ * alignment and tile height the ones of drm_vs_get_align_size and
+ * drm_vs_get_tile_height.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @desc: pointer to the descriptor to fill.
+ *
+ * Return 0 on success, -EINVAL if the format is unsupported with @mod.
+ */
+int drm_vs_get_format_desc(uint32_t format, uint64_t mod, drm_vs_format_desc *desc);
+
 /*
  * Prepare parameter values required by DRM_IOCTL_MODE_CREATE_DUMB
- * for each plane
+ * for each plane, -EOVERFLOW if a plane is too large for it.
  *
  * @width: aligned width obtained by drm_vs_get_align_size.
  *
@@ -160,6 +507,440 @@ int drm_vs_get_align_size(uint32_t *width, uint32_t *height, uint32_t format, ui
  */
 int drm_vs_bo_config(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
 		     drm_vs_bo_param bo_param[4]);
+
+/*
+ * Same as drm_vs_bo_config with all sizes computed in 64-bit, for surfaces
+ * up to VS_MAX_SURFACE_SIZE x VS_MAX_SURFACE_SIZE.
+ *
+ * @bo_param: point to drm_vs_bo_param64 object for each plane.
+ *
+ * @modifiers: point to the modifier of each plane.
+ *
+ * Return 0 on success, -EINVAL if the size or format is unsupported,
+ * -EOVERFLOW if a plane does not fit DRM_IOCTL_MODE_CREATE_DUMB,
+ * @bo_param being filled anyway.
+ */
+int drm_vs_bo_config64(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+		       drm_vs_bo_param64 bo_param[4], uint64_t modifiers[4]);
+
+/*
+ * Same as drm_vs_bo_config, also returns the modifier of each plane
+ * as vs_mod_config does.
+ *
+ * @modifiers: point to the modifier of each plane.
+ */
+int drm_vs_bo_config_ext(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			 drm_vs_bo_param bo_param[4], uint64_t modifiers[4]);
+
+/*
+ * Enable or disable the drm_vs_bo_config result cache, disabled by default.
+ * Results are memoized per (width, height, format, mod). Lookups are lock
+ * free and safe from any thread.
+ */
+void drm_vs_bo_cache_enable(bool enable);
+
+/* Drop all cached results and clear the counters. */
+void drm_vs_bo_cache_reset(void);
+
+/* Get hit/miss counters of the drm_vs_bo_config result cache. */
+void drm_vs_bo_cache_get_stats(drm_vs_bo_cache_stats *stats);
+
+/*
+ * Batched drm_vs_get_align_size, only width and height of
+ * each result are filled.
+ *
+ * @req: array of @count requests.
+ *
+ * @res: array of @count results, in the same order as @req.
+ *
+ * @count: number of requests.
+ */
+int drm_vs_get_align_size_batch(const drm_vs_bo_request *req, drm_vs_bo_result *res,
+				uint32_t count);
+
+/*
+ * Batched drm_vs_get_align_size followed by drm_vs_bo_config_ext.
+ * Requests sharing a format and modifier are decoded once.
+ *
+ * @req: array of @count requests.
+ *
+ * @res: array of @count results, in the same order as @req.
+ *
+ * @count: number of requests.
+ *
+ * Return 0 if every request succeeded, otherwise the error of a failed one,
+ * see drm_vs_bo_result.ret for each request.
+ */
+int drm_vs_bo_config_batch(const drm_vs_bo_request *req, drm_vs_bo_result *res, uint32_t count);
+
+/*
+ * Lay out all planes of a frame buffer in one buffer object, so a single
+ * DRM_IOCTL_MODE_CREATE_DUMB serves every plane. Each plane starts at
+ * a 64 byte boundary, 256 bytes for DEC400/DEC400A/PVRIC. The DEC400
+ * tile status follows the plane data, the PVRIC header precedes it.
+ * Sizes are computed as drm_vs_bo_config64 does.
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @layout: point to the layout to fill.
+ *
+ * Return 0 on success, -EOVERFLOW if the buffer does not fit a single
+ * DRM_IOCTL_MODE_CREATE_DUMB, @layout being filled anyway.
+ */
+int drm_vs_get_bo_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			 drm_vs_bo_layout *layout);
+
+/*
+ * Same as drm_vs_get_bo_layout, with every plane and the buffer size
+ * aligned to @page_size, so that the buffer can be mapped with large IOMMU
+ * pages and no plane shares a page with another. Linear pitches are padded
+ * to a divisor or multiple of the page when that costs at most 1/16 of a
+ * row, so that fewer rows straddle two pages. The DEC400/DEC400A tile
+ * status stays right after the plane data and the PVRIC header right
+ * before it, where a driver derives them from the ADDFB2 offsets.
+ *
+ * @page_size: VS_PAGE_SIZE_4K, VS_PAGE_SIZE_64K or VS_PAGE_SIZE_2M.
+ *
+ * @cost: optional, point to the memory cost and TLB footprint to fill.
+ *
+ * Return 0 on success, -EINVAL for an unsupported @page_size, error of
+ * drm_vs_get_bo_layout otherwise.
+ */
+int drm_vs_get_bo_layout_paged(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			       uint64_t page_size, drm_vs_bo_layout *layout,
+			       drm_vs_page_cost *cost);
+
+/*
+ * Split a surface laid out by drm_vs_get_bo_layout into side by side
+ * parts, one per display pipe. Split points are aligned to the tile,
+ * superblock and compression unit of every plane, including the tile
+ * status byte of DEC400 so each pipe owns whole tile status bytes, and to
+ * the fetch alignment of each plane. Pipes share the plane pitches of
+ * the layout.
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @num_pipes: number of pipes, VS_MAX_SPLIT_PIPES at most.
+ *
+ * @split: point to the split layout to fill.
+ *
+ * Return 0 on success, -ERANGE if @width is too narrow for @num_pipes
+ * aligned parts, -EINVAL or error of drm_vs_get_bo_layout otherwise.
+ */
+int drm_vs_get_split_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			    uint32_t num_pipes, drm_vs_split_layout *split);
+
+/*
+ * Choose the tile mode for a buffer scanned out with @rotation. The
+ * display reads rows of the buffer for 0/180 degrees and columns for
+ * 90/270 degrees, so tile modes whose tiles run along the scan, e.g.
+ * SUPER_TILED_YMAJOR_4X8 or DEC_TILE_8X8_YMAJOR for portrait panels, keep
+ * full bursts. Every tile mode of the modifier family of @mod that the
+ * format supports is tried, other modifier bits are kept. Candidates are
+ * ranked by efficiency, then by fewer lines fetched at once, then by the
+ * smaller buffer.
+ *
+ * @width: unaligned buffer width, before rotation.
+ *
+ * @height: unaligned buffer height, before rotation.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: modifier giving the family and flags of the candidates.
+ *
+ * @rotation: VS_ROTATION_0/90/180/270.
+ *
+ * @rotated: the chosen modifier with its aligned size, bo params and layout.
+ *
+ * Return 0 on success, -EINVAL if no tile mode fits.
+ */
+int drm_vs_get_rotated_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			      uint32_t rotation, drm_vs_rotated_layout *rotated);
+
+/*
+ * Rank modifiers for a plane by allocated bytes and estimated bytes fetched
+ * per frame. Sizes come from drm_vs_get_bo_layout. Fetched bytes count
+ * lossless DEC400/DEC400A/PVRIC data at @model->compress_ratio plus tile
+ * status/header, lossy and fixed rate data as allocated, and are scaled
+ * by the burst efficiency of drm_vs_get_rotated_layout for the rotation.
+ *
+ * @width: unaligned width.
+ *
+ * @height: unaligned height.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mods: modifiers the plane supports, NULL for every tile mode of the
+ *        normal, DEC400, DEC400A, PVRIC, DECNano and ETC2 families.
+ *        Lossy modifiers are skipped unless @model->allow_lossy is set,
+ *        PVRIC being also ranked with DEC_LOSSY then.
+ *
+ * @num_mods: number of entries of @mods.
+ *
+ * @model: cost model, NULL for no rotation, 50% compression, equal
+ *         weights and lossless modifiers only.
+ *
+ * @ranks: filled with the cheapest candidates, best first.
+ *
+ * @max_ranks: number of entries of @ranks.
+ *
+ * Return the number of ranked candidates on success, -EINVAL if none fits.
+ */
+int drm_vs_negotiate_mod(uint32_t width, uint32_t height, uint32_t format, const uint64_t *mods,
+			 uint32_t num_mods, const drm_vs_mod_cost_model *model,
+			 drm_vs_mod_rank *ranks, uint32_t max_ranks);
+
+/*
+ * Map damage rectangles of a frame buffer to the tiles and bytes to
+ * upload or flush. Rectangles are grown to whole tiles of every plane,
+ * whole DEC400 tile status bytes (4 bit status per 256 byte unit, 8 bit
+ * for UNIT2X2 and 128 byte tiles) and whole DEC400A superblocks, then
+ * coalesced. Data and tile status/header ranges follow the single buffer
+ * layout of drm_vs_get_bo_layout.
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @damage: damaged rectangles, clipped to the frame buffer.
+ *
+ * @num_damage: number of entries in @damage.
+ *
+ * @map: filled with dirty rectangles and byte ranges, see drm_vs_damage_map.
+ *
+ * Return 0 on success, -ENOMEM, -EINVAL or error of drm_vs_get_bo_layout.
+ */
+int drm_vs_map_damage(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+		      const struct drm_vs_rect *damage, uint32_t num_damage,
+		      drm_vs_damage_map *map);
+
+/*
+ * Fill a complete DRM_IOCTL_MODE_ADDFB2 request: handles, pitches, offsets
+ * and the modifier of each plane, the chroma plane modifier of DEC400
+ * formats being demoted as vs_mod_config does.
+ * For dma-buf import, pitches, offsets and modifier are the values to
+ * pass along with the dma-buf fd of each plane.
+ *
+ * @width: frame buffer width, aligned internally by drm_vs_get_align_size.
+ *
+ * @height: frame buffer height, aligned internally by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @handles: GEM handles, either one per plane as allocated with
+ *           drm_vs_bo_config, or a single one laid out by drm_vs_get_bo_layout.
+ *
+ * @num_handles: number of entries in @handles.
+ *
+ * @fb: point to the request to fill.
+ */
+int drm_vs_fill_fb_cmd2(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			const uint32_t *handles, uint32_t num_handles, struct drm_mode_fb_cmd2 *fb);
+
+/*
+ * Same as drm_vs_fill_fb_cmd2 with a single handle, for a buffer object
+ * laid out by drm_vs_get_bo_layout or drm_vs_get_bo_layout_paged.
+ *
+ * @width: frame buffer width.
+ *
+ * @height: frame buffer height.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @layout: layout of the buffer object, for the same format.
+ *
+ * @handle: GEM handle of the buffer object.
+ *
+ * @fb: point to the request to fill.
+ *
+ * Return 0 on success, -EINVAL on invalid arguments, -ERANGE if a plane
+ * offset does not fit the request.
+ */
+int drm_vs_fill_fb_cmd2_layout(uint32_t width, uint32_t height, uint32_t format,
+			       const drm_vs_bo_layout *layout, uint32_t handle,
+			       struct drm_mode_fb_cmd2 *fb);
+
+/*
+ * Compute the frame memory a display configuration needs, each buffer
+ * being sized as drm_vs_calibrate_bo_size does: one buffer object per
+ * format plane, tile status/header included, rounded up to 4KB pages as
+ * DRM_IOCTL_MODE_CREATE_DUMB allocates them.
+ *
+ * @displays: displays to plan, plane results being filled.
+ *
+ * @num_displays: number of entries in @displays, VS_DISPLAY_COUNT at most.
+ *
+ * @total: point to the bytes needed by all displays.
+ *
+ * Return 0 on success, error of drm_vs_bo_config64 for the first plane
+ * that cannot be allocated otherwise.
+ */
+int drm_vs_plan_frame_memory(drm_vs_plan_display *displays, uint32_t num_displays,
+			     uint64_t *total);
+
+/*
+ * Find which compression choice fits a frame memory cap. Every candidate
+ * modifier is tried on all planes, planes whose format does not support
+ * it keeping their own modifier.
+ *
+ * @displays: displays to plan, left untouched.
+ *
+ * @num_displays: number of entries in @displays.
+ *
+ * @mods: candidate modifiers, in order of preference.
+ *
+ * @num_mods: number of entries in @mods.
+ *
+ * @cap: bytes of memory available.
+ *
+ * @totals: optional, bytes needed with each candidate, UINT64_MAX if the
+ *          candidate cannot be used.
+ *
+ * Return the index in @mods of the first candidate fitting @cap, -ENOSPC if
+ * none does, -EINVAL on invalid arguments.
+ */
+int drm_vs_plan_choose_mod(const drm_vs_plan_display *displays, uint32_t num_displays,
+			   const uint64_t *mods, uint32_t num_mods, uint64_t cap, uint64_t *totals);
+
+/*
+ * Estimate the read bandwidth of a display configuration at the refresh
+ * rate of each display mode. Each plane reads its source buffer, sized by
+ * drm_vs_get_bo_layout, once per frame: lossless DEC400/DEC400A/PVRIC data
+ * at @model->compress_ratio plus tile status/header, other data as
+ * allocated, scaled by the burst efficiency of @model->rotation as for
+ * drm_vs_negotiate_mod. A plane scaled to fewer lines than the display
+ * reads all of its source while its own lines scan out, which the peak
+ * bandwidth accounts for.
+ *
+ * @displays: displays with their mode and planes, bandwidths are filled.
+ *
+ * @num_displays: number of displays, VS_DISPLAY_COUNT at most.
+ *
+ * @model: compression ratio and rotation, weights unused, NULL for the
+ *         defaults of drm_vs_negotiate_mod.
+ *
+ * @total: average read bandwidth of all displays, in bytes per second.
+ *
+ * Return 0 on success, -EINVAL if a plane cannot be laid out.
+ */
+int drm_vs_estimate_bandwidth(drm_vs_bw_display *displays, uint32_t num_displays,
+			      const drm_vs_mod_cost_model *model, uint64_t *total);
+
+/*
+ * Predict whether a set of planes can be committed on a display whose
+ * timing was set by drm_vs_display_set_timing. Each plane is checked
+ * against the scaler ratio limits, the vertical line buffer its filter
+ * needs (tap_v source lines of 32-bit pixels, see drm_vs_get_filter_tap)
+ * and the display area; the set against the fetch bandwidth, summing the
+ * peak bandwidth of the planes as drm_vs_estimate_bandwidth does.
+ *
+ * @display_id: display the planes are committed to.
+ *
+ * @planes: planes with format, modifier, rects and filter; cost and
+ *          status of each plane are filled.
+ *
+ * @num_planes: number of entries in @planes.
+ *
+ * @limits: limits of the display.
+ *
+ * @bandwidth: optional, peak read bandwidth of the set in bytes per second.
+ *
+ * Return 0 if the set fits, -ERANGE if a plane breaks a scaler limit or
+ * leaves the display, -ENOSPC if the set exceeds the fetch bandwidth,
+ * -EINVAL on invalid arguments or planes.
+ */
+int drm_vs_admit_planes(vs_display_id display_id, drm_vs_admit_plane *planes,
+			uint32_t num_planes, const drm_vs_dpu_limits *limits, uint64_t *bandwidth);
+
+/*
+ * Codes of DEC400 tile status (4 bits per tile, 8 bits for UNIT2X2) and of
+ * PVRIC headers (8 bits per tile). Other codes are compressed tiles that
+ * fetch code / 16 (4 bits) or code / 256 (8 bits) of the tile.
+ */
+#define VS_TS_CODE_UNCOMPRESSED 0x0
+#define VS_TS_CODE_CLEAR 0x1
+
+/* tile status bytes of cleared DEC400 tiles */
+#define VS_DEC_TS_CLEAR_4BIT 0x11
+#define VS_DEC_TS_CLEAR_8BIT 0x01
+
+/*
+ * Mark every tile of a DEC400 plane as cleared, writing only its tile status
+ * and the fast clear color of DRM_FORMAT_MOD_VS_DEC_FC instead of the whole
+ * surface.
+ *
+ * @ts: tile status of the plane, e.g. at layout.ts_offsets[i] of
+ *      drm_vs_get_bo_layout, holding bo_param->ts_buf_size bytes. With
+ *      DRM_FORMAT_MOD_VS_DEC_FC, the fast clear area follows the row
+ *      aligned tile status, both within the calibrated plane height.
+ *
+ * @bo_param: the plane calibrated by drm_vs_calibrate_bo_size or
+ *            drm_vs_bo_config.
+ *
+ * @modifier: modifier of the plane, e.g. layout.modifiers[i].
+ *
+ * @clear_color: pixel value of the plane format, repeated over the fast
+ *               clear area, in 32 bit words for formats of partial bytes.
+ *
+ * Return 0 on success, -EINVAL if the plane is not a calibrated DEC400 plane.
+ */
+int drm_vs_clear_tile_status(void *ts, const drm_vs_bo_param *bo_param, uint64_t modifier,
+			     uint64_t clear_color);
+
+typedef struct drm_vs_compression_stats {
+	uint64_t tiles;
+	uint64_t clear_tiles;
+	uint64_t compressed_tiles;
+	uint64_t uncompressed_tiles;
+	/* bytes of the tiles uncompressed, and bytes fetched with tile status/header */
+	uint64_t raw_bytes;
+	uint64_t fetch_bytes;
+	/* fetch_bytes in percent of raw_bytes, e.g. for drm_vs_mod_cost_model */
+	uint32_t ratio;
+} drm_vs_compression_stats;
+
+/*
+ * Measure how well a DEC400 or PVRIC plane compresses from its tile status
+ * or header, e.g. on sampled frames. Every code is counted, SSE2 or NEON
+ * when available.
+ *
+ * @ts: DEC400 tile status or PVRIC header of the plane, e.g. at
+ *      layout.ts_offsets[i] of drm_vs_get_bo_layout.
+ *
+ * @bo_param: the plane calibrated by drm_vs_calibrate_bo_size or
+ *            drm_vs_bo_config.
+ *
+ * @modifier: modifier of the plane, e.g. layout.modifiers[i].
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @stats: tile counts and estimated bytes fetched per frame. Lossy PVRIC
+ *         tiles fetch their fixed packed size.
+ *
+ * Return 0 on success, -EINVAL for other modifiers.
+ */
+int drm_vs_analyze_compression(const void *ts, const drm_vs_bo_param *bo_param,
+			       uint64_t modifier, uint32_t format,
+			       drm_vs_compression_stats *stats);
+
 /*
 + * Prepare ltm freq_decomp norm parameter values
 + * for ltm freq_decomp norm
@@ -195,6 +976,7 @@ const char *drm_vs_get_info_filter_name(enum drm_vs_filter_type filter_type);
  *
  * @format: 4CC format identifier (DRM_FORMAT_*).
  *
+ * Sizes are truncated to 32 bits, see drm_vs_bo_config64 for large surfaces.
  */
 void drm_vs_calibrate_bo_size(drm_vs_bo_param *bo_param, uint64_t modifier, uint32_t format);
 
@@ -0,0 +1,180 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Inline fast paths of the hot queries of vs_bo_helper.
+ *
+ * When format and modifier are compile time constants the alignment is
+ * folded by the compiler from vs_bo_format_def.h, otherwise the query goes
+ * to libvs_bo_helper.so. Results are the same as the library ones.
+ */
+
+#ifndef __VS_BO_INLINE_H__
+#define __VS_BO_INLINE_H__
+
+#include <drm/vs_drm_fourcc.h>
+#include <stdint.h>
+
+#include "vs_bo_format_def.h"
+#include "vs_bo_helper.h"
+
+/* align needs to be power of 2 */
+#define VS_UP_ALIGN(x, align) (((x) + (align)-1) & ~((align)-1))
+
+/* align with non-power of 2 */
+#define VS_ALIGN_NP2(n, align) (((n) + (align)-1) - (((n) + (align)-1) % (align)))
+
+#ifndef fourcc_mod_get_vendor
+#define fourcc_mod_get_vendor(val) (((val) >> 56) & 0xff)
+#endif
+
+#define fourcc_mod_vs_get_type(val) (((val)&DRM_FORMAT_MOD_VS_TYPE_MASK) >> 53)
+#define fourcc_mod_vs_get_tile_mode(val) (uint8_t)((val)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK)
+#define fourcc_mod_vs_is_compressed(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_COMPRESSED ? 1 : 0)
+#define fourcc_mod_vs_is_dec400a(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_DEC400A ? 1 : 0)
+#define fourcc_mod_vs_is_pvric(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_PVRIC ? 1 : 0)
+#define fourcc_mod_vs_is_decnano(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_DECNANO ? 1 : 0)
+#define fourcc_mod_vs_is_etc2(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_ETC2 ? 1 : 0)
+#define fourcc_mod_vs_is_normal(val) \
+	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_NORMAL ? 1 : 0)
+
+#define VS_INLINE_MOD_TYPE(type, family)     \
+	case DRM_FORMAT_MOD_VS_TYPE_##type: \
+		return VS_MOD_FAMILY_##family;
+#define VS_INLINE_FORMAT_CLASS(fmt, cls, std, custom, dec400a) \
+	case DRM_FORMAT_##fmt:                                 \
+		return VS_FORMAT_CLASS_##cls;
+#define VS_INLINE_DEC_TILE(tile, pixels) \
+	case DRM_FORMAT_MOD_VS_##tile:   \
+		return pixels * bpp / 8;
+/* rules for any class first, class specific ones override them */
+#define VS_INLINE_ALIGN_ANY(fam, tile, cls, w, h)                                     \
+	if (family == VS_MOD_FAMILY_##fam && tile_mode == DRM_FORMAT_MOD_VS_##tile && \
+	    VS_FORMAT_CLASS_##cls == VS_FORMAT_CLASS_ANY) {                           \
+		align_w = w;                                                          \
+		align_h = h;                                                          \
+	}
+#define VS_INLINE_ALIGN_CLASS(fam, tile, cls, w, h)                                   \
+	if (family == VS_MOD_FAMILY_##fam && tile_mode == DRM_FORMAT_MOD_VS_##tile && \
+	    fmt_class == VS_FORMAT_CLASS_##cls) {                                     \
+		align_w = w;                                                          \
+		align_h = h;                                                          \
+	}
+
+/*
+ * Get the modifier family of @mod, DEC400A and unknown modifier types
+ * being separate families.
+ */
+static inline vs_mod_family drm_vs_inline_mod_family(uint64_t mod)
+{
+	switch (fourcc_mod_vs_get_type(mod)) {
+		VS_MOD_TYPE_LIST(VS_INLINE_MOD_TYPE)
+	default:
+		return VS_MOD_FAMILY_OTHER;
+	}
+}
+
+/*
+ * Get the alignment class of @format, VS_FORMAT_CLASS_DEFAULT for
+ * formats not described in vs_bo_format_def.h.
+ */
+static inline vs_format_class drm_vs_inline_format_class(uint32_t format)
+{
+	switch (format) {
+		VS_FORMAT_LIST(VS_INLINE_FORMAT_CLASS)
+	default:
+		return VS_FORMAT_CLASS_DEFAULT;
+	}
+}
+
+/*
+ * Same as vs_get_dec_tile_size.
+ *
+ * @tile_mode: DEC400 tile mode, fourcc_mod_vs_get_tile_mode() of the modifier.
+ *
+ * @bpp: bits per pixel of the plane.
+ */
+static inline uint16_t drm_vs_inline_dec_tile_size(uint8_t tile_mode, uint8_t bpp)
+{
+	switch (tile_mode) {
+		VS_DEC_TILE_LIST(VS_INLINE_DEC_TILE)
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Same as drm_vs_get_align_size, evaluated in the caller when @format
+ * and @mod are known at compile time and by the library otherwise.
+ *
+ * @width: pointer to aligned width.
+ *
+ * @height: pointer to aligned height.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ */
+static inline int drm_vs_inline_align_size(uint32_t *width, uint32_t *height, uint32_t format,
+					   uint64_t mod)
+{
+	vs_mod_family family;
+	vs_format_class fmt_class;
+	uint8_t tile_mode;
+	uint32_t align_w = 1, align_h = 1;
+
+	if (!__builtin_constant_p(format) || !__builtin_constant_p(mod))
+		return drm_vs_get_align_size(width, height, format, mod);
+
+	family = drm_vs_inline_mod_family(mod);
+	fmt_class = drm_vs_inline_format_class(format);
+	tile_mode = fourcc_mod_vs_get_tile_mode(mod);
+
+	/* DEC400A and unknown modifier types are aligned as normal ones */
+	if (family == VS_MOD_FAMILY_DEC400A || family == VS_MOD_FAMILY_OTHER)
+		family = VS_MOD_FAMILY_NORMAL;
+
+	VS_ALIGN_LIST(VS_INLINE_ALIGN_ANY)
+	VS_ALIGN_LIST(VS_INLINE_ALIGN_CLASS)
+
+	*width = VS_UP_ALIGN(*width, align_w);
+	*height = VS_UP_ALIGN(*height, align_h);
+
+	return 0;
+}
+
+#undef VS_INLINE_MOD_TYPE
+#undef VS_INLINE_FORMAT_CLASS
+#undef VS_INLINE_DEC_TILE
+#undef VS_INLINE_ALIGN_ANY
+#undef VS_INLINE_ALIGN_CLASS
+
+#endif /* __VS_BO_INLINE_H__ */
@@ -0,0 +1,538 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * C++17 compile time counterpart of drm_vs_get_align_size and
+ * drm_vs_bo_config, built from the descriptor lists of vs_bo_format_def.h.
+ *
+ *   using nv12_dec = vs::layout<DRM_FORMAT_NV12, mod>;
+ *   constexpr vs::bo_config cfg = nv12_dec::config(1920, 1080);
+ *   static_assert(cfg.ret == 0 && cfg.num_planes == 2);
+ *
+ * vs::check_against_c() compares a result with the C library.
+ */
+
+#ifndef __VS_BO_LAYOUT_HPP__
+#define __VS_BO_LAYOUT_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+extern "C" {
+#include "vs_bo_format_def.h"
+#include "vs_bo_helper.h"
+}
+
+namespace vs
+{
+struct extent {
+	uint32_t width;
+	uint32_t height;
+};
+
+/* drm_vs_bo_param of one plane and its modifier from vs_mod_config */
+struct plane_param {
+	uint32_t width;
+	uint32_t height;
+	uint8_t bpp;
+	uint32_t header_size;
+	uint32_t ts_buf_size;
+	uint64_t modifier;
+};
+
+/* drm_vs_bo_config result, @ret being its return value */
+struct bo_config {
+	int ret;
+	uint32_t num_planes;
+	plane_param plane[4];
+};
+
+namespace detail
+{
+struct format_entry {
+	uint32_t format;
+	uint8_t fmt_class;
+	vs_layout_desc layout[VS_LAYOUT_COUNT];
+};
+
+struct align_rule {
+	uint8_t family;
+	uint8_t tile_mode;
+	uint8_t fmt_class;
+	uint16_t width;
+	uint16_t height;
+};
+
+struct block_rule {
+	uint8_t family;
+	uint8_t tile_mode;
+	uint8_t width;
+	uint8_t height;
+	uint8_t ratio;
+};
+
+struct etc2_format {
+	uint32_t format;
+	uint32_t bytes;
+};
+
+struct superblock {
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+};
+
+struct pvric_lossy {
+	uint32_t format;
+	uint32_t bytes;
+};
+
+struct chroma_mod_rule {
+	uint32_t format;
+	uint8_t tile_mode;
+	uint8_t chroma_tile_mode;
+};
+
+#define VS_FORMAT_ENTRY(fmt, cls, std, custom, dec400a) \
+	{ DRM_FORMAT_##fmt, VS_FORMAT_CLASS_##cls, { std, custom, dec400a } },
+#define VS_ALIGN_ENTRY(fam, tile, cls, w, h) \
+	{ VS_MOD_FAMILY_##fam, DRM_FORMAT_MOD_VS_##tile, VS_FORMAT_CLASS_##cls, w, h },
+#define VS_BLOCK_ENTRY(fam, tile, w, h, ratio) \
+	{ VS_MOD_FAMILY_##fam, DRM_FORMAT_MOD_VS_##tile, w, h, ratio },
+#define VS_ETC2_FORMAT_ENTRY(fmt, bytes) { DRM_FORMAT_##fmt, bytes },
+#define VS_CHROMA_MOD_ENTRY(fmt, tile, chroma_tile) \
+	{ DRM_FORMAT_##fmt, DRM_FORMAT_MOD_VS_##tile, DRM_FORMAT_MOD_VS_##chroma_tile },
+#define VS_MOD_TYPE_CASE(type, family)      \
+	case DRM_FORMAT_MOD_VS_TYPE_##type: \
+		return VS_MOD_FAMILY_##family;
+#define VS_DEC_TS_8BIT_CASE(tile) case DRM_FORMAT_MOD_VS_##tile:
+#define VS_DEC400A_SUPERBLOCK_ENTRY(fmt, w, h) { DRM_FORMAT_##fmt, w, h },
+#define VS_PVRIC_LOSSY_ENTRY(fmt, bytes) { DRM_FORMAT_##fmt, bytes },
+#define VS_DEC_TILE_CASE(tile, pixels) \
+	case DRM_FORMAT_MOD_VS_##tile:  \
+		return pixels;
+#define VS_PVRIC_TILE_CASE(tile, height) \
+	case DRM_FORMAT_MOD_VS_##tile:    \
+		return height;
+
+/* entry 0 describes the formats missing from the list */
+inline constexpr format_entry formats[] = {
+	{ 0, VS_FORMAT_CLASS_DEFAULT, { VS_PLANES_DEFAULT, VS_PLANES_NONE, VS_PLANES_DEFAULT } },
+	VS_FORMAT_LIST(VS_FORMAT_ENTRY)
+};
+
+inline constexpr align_rule align_rules[] = { VS_ALIGN_LIST(VS_ALIGN_ENTRY) };
+
+inline constexpr block_rule block_rules[] = { VS_BLOCK_LIST(VS_BLOCK_ENTRY) };
+
+inline constexpr etc2_format etc2_formats[] = { VS_ETC2_FORMAT_LIST(VS_ETC2_FORMAT_ENTRY) };
+
+inline constexpr chroma_mod_rule chroma_mod_rules[] = { VS_CHROMA_MOD_LIST(VS_CHROMA_MOD_ENTRY) };
+
+inline constexpr superblock dec400a_superblocks[] = { VS_DEC400A_SUPERBLOCK_LIST(
+	VS_DEC400A_SUPERBLOCK_ENTRY) };
+
+inline constexpr pvric_lossy pvric_lossy_formats[] = { VS_PVRIC_LOSSY_LIST(VS_PVRIC_LOSSY_ENTRY) };
+
+constexpr bool dec_ts_is_8bit(uint8_t tile_mode)
+{
+	switch (tile_mode) {
+		VS_DEC_TS_8BIT_LIST(VS_DEC_TS_8BIT_CASE)
+		return true;
+	default:
+		return false;
+	}
+}
+
+constexpr uint16_t dec_tile_pixels(uint8_t tile_mode)
+{
+	switch (tile_mode) {
+		VS_DEC_TILE_LIST(VS_DEC_TILE_CASE)
+	default:
+		return 0;
+	}
+}
+
+constexpr uint16_t pvric_tile_height(uint8_t tile_mode)
+{
+	switch (tile_mode) {
+		VS_PVRIC_TILE_LIST(VS_PVRIC_TILE_CASE)
+	default:
+		return 1;
+	}
+}
+
+constexpr vs_mod_family mod_family(uint64_t mod)
+{
+	switch ((mod & DRM_FORMAT_MOD_VS_TYPE_MASK) >> 53) {
+		VS_MOD_TYPE_LIST(VS_MOD_TYPE_CASE)
+	default:
+		return VS_MOD_FAMILY_OTHER;
+	}
+}
+
+#undef VS_FORMAT_ENTRY
+#undef VS_ALIGN_ENTRY
+#undef VS_BLOCK_ENTRY
+#undef VS_ETC2_FORMAT_ENTRY
+#undef VS_CHROMA_MOD_ENTRY
+#undef VS_MOD_TYPE_CASE
+#undef VS_DEC_TS_8BIT_CASE
+#undef VS_DEC400A_SUPERBLOCK_ENTRY
+#undef VS_PVRIC_LOSSY_ENTRY
+#undef VS_DEC_TILE_CASE
+#undef VS_PVRIC_TILE_CASE
+
+/* same as VS_UP_ALIGN and VS_ALIGN_NP2 of vs_bo_inline.h */
+constexpr uint64_t up_align(uint64_t x, uint64_t align)
+{
+	return (x + align - 1) & ~(align - 1);
+}
+
+constexpr uint64_t align_np2(uint64_t n, uint64_t align)
+{
+	return (n + align - 1) - ((n + align - 1) % align);
+}
+
+constexpr const format_entry &find_format(uint32_t format)
+{
+	for (std::size_t i = 1; i < std::size(formats); i++) {
+		if (formats[i].format == format)
+			return formats[i];
+	}
+
+	return formats[0];
+}
+
+constexpr uint8_t tile_mode(uint64_t mod)
+{
+	return static_cast<uint8_t>(mod & DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
+}
+
+constexpr const vs_layout_desc &find_layout(uint32_t format, uint64_t mod)
+{
+	const format_entry &fmt = find_format(format);
+
+	if (mod_family(mod) == VS_MOD_FAMILY_DEC400A)
+		return fmt.layout[VS_LAYOUT_DEC400A];
+
+	return fmt.layout[fourcc_mod_is_custom_format(mod) ? VS_LAYOUT_CUSTOM : VS_LAYOUT_STANDARD];
+}
+
+/* _vs_get_etc2_block_bytes */
+constexpr uint32_t etc2_block_bytes(uint32_t format)
+{
+	for (const etc2_format &etc2 : etc2_formats) {
+		if (etc2.format == format)
+			return etc2.bytes;
+	}
+
+	return 0;
+}
+
+/* _vs_get_dec400a_superblock */
+constexpr superblock dec400a_superblock(uint32_t format)
+{
+	for (const superblock &sb : dec400a_superblocks) {
+		if (sb.format == format)
+			return sb;
+	}
+
+	return { format, VS_DEC400A_SUPERBLOCK_W, VS_DEC400A_SUPERBLOCK_H };
+}
+
+/* _vs_get_pvric_lossy_bytes */
+constexpr uint32_t pvric_lossy_bytes(uint32_t format)
+{
+	for (const pvric_lossy &lossy : pvric_lossy_formats) {
+		if (lossy.format == format)
+			return lossy.bytes;
+	}
+
+	return VS_PVRIC_LOSSY_BYTES;
+}
+
+/* vs_mod_config */
+constexpr int mod_config(uint32_t format, uint64_t mod, uint32_t num_planes, uint64_t modifiers[4])
+{
+	bool listed = false;
+
+	if (mod_family(mod) == VS_MOD_FAMILY_DEC400) {
+		for (const chroma_mod_rule &rule : chroma_mod_rules) {
+			if (rule.format != format)
+				continue;
+
+			listed = true;
+			if (rule.tile_mode != tile_mode(mod))
+				continue;
+
+			modifiers[0] = mod;
+			modifiers[1] = fourcc_mod_vs_dec_code(rule.chroma_tile_mode,
+							      DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
+			return 0;
+		}
+
+		if (listed)
+			return -EINVAL;
+	}
+
+	for (uint32_t i = 0; i < num_planes; i++)
+		modifiers[i] = mod;
+
+	return 0;
+}
+
+struct size64 {
+	uint64_t height;
+	uint64_t header_size;
+	uint64_t ts_buf_size;
+};
+
+/* _vs_calibrate_bo_size64 */
+constexpr size64 calibrate(uint32_t width, uint64_t height, uint8_t bpp, uint64_t mod,
+			   uint32_t format)
+{
+	size64 size = { height, 0, 0 };
+	uint64_t stride = static_cast<uint64_t>(width) * bpp / 8;
+	uint64_t aligned_area = 0, ts_buf_size = 0, tile_cnt = 0;
+	uint16_t tile_size = 0;
+	superblock sb = {};
+
+	switch (mod_family(mod)) {
+	case VS_MOD_FAMILY_DEC400:
+		tile_size = static_cast<uint16_t>(dec_tile_pixels(tile_mode(mod)) * bpp / 8);
+		if (!tile_size || !stride)
+			break;
+
+		aligned_area = align_np2(stride, tile_size) * height;
+		ts_buf_size = align_np2(VS_DEC_TS_SIZE(aligned_area, tile_size,
+						       dec_ts_is_8bit(tile_mode(mod))),
+					stride);
+
+		size.ts_buf_size = ts_buf_size;
+		if (dec_mod_is_fc(mod))
+			size.ts_buf_size += VS_DEC_FC_SIZE(dec_mod_get_fc_size(mod));
+		size.height += align_np2(size.ts_buf_size, stride) / stride;
+		break;
+	case VS_MOD_FAMILY_DEC400A:
+		if (!stride)
+			break;
+
+		sb = dec400a_superblock(format);
+		ts_buf_size = VS_DEC400A_TS_SIZE(width, height, sb.width, sb.height);
+
+		size.ts_buf_size = ts_buf_size;
+		size.height += align_np2(ts_buf_size, stride) / stride;
+		break;
+	case VS_MOD_FAMILY_PVRIC:
+		if (!stride)
+			break;
+
+		aligned_area = up_align(stride, 256 / pvric_tile_height(tile_mode(mod))) * height;
+		tile_cnt = aligned_area / 256;
+		ts_buf_size = up_align(tile_cnt + 256, stride);
+
+		if (!(mod & DRM_FORMAT_MOD_VS_DEC_LOSSY))
+			aligned_area += ts_buf_size;
+		else
+			aligned_area = ts_buf_size +
+				       up_align(tile_cnt * pvric_lossy_bytes(format), stride);
+
+		size.height = aligned_area / stride;
+		size.header_size = tile_cnt;
+		break;
+	case VS_MOD_FAMILY_DECNANO:
+	case VS_MOD_FAMILY_ETC2:
+		for (const block_rule &block : block_rules) {
+			if (block.family != mod_family(mod) || block.tile_mode != tile_mode(mod) ||
+			    !stride)
+				continue;
+
+			uint32_t block_bytes = block.ratio ?
+						       block.width * block.height * bpp / 8 / block.ratio :
+						       etc2_block_bytes(format);
+			if (!block_bytes)
+				continue;
+
+			tile_cnt = static_cast<uint64_t>((width + block.width - 1) / block.width) *
+				   ((height + block.height - 1) / block.height);
+			aligned_area = tile_cnt * block_bytes;
+			size.height = (aligned_area + stride - 1) / stride;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return size;
+}
+
+/* _vs_bo_fits_dumb */
+constexpr bool fits_dumb(uint32_t width, uint8_t bpp, const size64 &size)
+{
+	uint64_t stride = static_cast<uint64_t>((bpp + 7) / 8) * width;
+
+	if (stride > UINT32_MAX || size.height > UINT32_MAX)
+		return false;
+	if (stride && size.height > UINT32_MAX / stride)
+		return false;
+
+	return size.header_size <= UINT32_MAX && size.ts_buf_size <= UINT32_MAX;
+}
+} /* namespace detail */
+
+/* drm_vs_get_align_size */
+constexpr extent aligned_size(uint32_t width, uint32_t height, uint32_t format, uint64_t mod)
+{
+	vs_mod_family family = detail::mod_family(mod);
+	uint8_t fmt_class = detail::find_format(format).fmt_class;
+	uint8_t tile_mode = detail::tile_mode(mod);
+	uint32_t align_w = 1, align_h = 1;
+
+	/* DEC400A and unknown modifier types are aligned as normal ones */
+	if (family == VS_MOD_FAMILY_DEC400A || family == VS_MOD_FAMILY_OTHER)
+		family = VS_MOD_FAMILY_NORMAL;
+
+	/* class specific rules override the ones for any class */
+	for (int pass = 0; pass < 2; pass++) {
+		for (const detail::align_rule &rule : detail::align_rules) {
+			if (rule.family != family || rule.tile_mode != tile_mode)
+				continue;
+			if (pass == 0 ? rule.fmt_class != VS_FORMAT_CLASS_ANY :
+					rule.fmt_class != fmt_class)
+				continue;
+
+			align_w = rule.width;
+			align_h = rule.height;
+		}
+	}
+
+	return { static_cast<uint32_t>(detail::up_align(width, align_w)),
+		 static_cast<uint32_t>(detail::up_align(height, align_h)) };
+}
+
+/* drm_vs_bo_config_ext, @width and @height being already aligned */
+constexpr bo_config config(uint32_t width, uint32_t height, uint32_t format, uint64_t mod)
+{
+	const vs_layout_desc &layout = detail::find_layout(format, mod);
+	bo_config cfg = {};
+	uint64_t modifiers[4] = {};
+
+	if (!layout.num_planes || detail::mod_config(format, mod, layout.num_planes, modifiers)) {
+		cfg.ret = -EINVAL;
+		return cfg;
+	}
+
+	cfg.num_planes = layout.num_planes;
+	for (uint32_t i = 0; i < 4; i++)
+		cfg.plane[i].modifier = modifiers[i];
+
+	for (uint32_t i = 0; i < layout.num_planes; i++) {
+		plane_param &plane = cfg.plane[i];
+		detail::size64 size = {};
+
+		plane.width = width / layout.plane[i].width_div;
+		plane.height = height / layout.plane[i].height_div;
+		plane.bpp = layout.plane[i].bpp;
+
+		size = detail::calibrate(plane.width, plane.height, plane.bpp, modifiers[i], format);
+		plane.height = static_cast<uint32_t>(size.height);
+		plane.header_size = static_cast<uint32_t>(size.header_size);
+		plane.ts_buf_size = static_cast<uint32_t>(size.ts_buf_size);
+
+		if (!detail::fits_dumb(plane.width, plane.bpp, size)) {
+			cfg.ret = -EOVERFLOW;
+			return cfg;
+		}
+	}
+
+	return cfg;
+}
+
+/* layout of a format/modifier pair fixed at compile time */
+template <uint32_t Format, uint64_t Mod> struct layout {
+	static constexpr uint32_t format = Format;
+	static constexpr uint64_t modifier = Mod;
+	static constexpr uint32_t num_planes = detail::find_layout(Format, Mod).num_planes;
+
+	static constexpr extent align(uint32_t width, uint32_t height)
+	{
+		return aligned_size(width, height, Format, Mod);
+	}
+
+	/* aligns @width and @height first, as drm_vs_bo_config_batch does */
+	static constexpr bo_config config(uint32_t width, uint32_t height)
+	{
+		extent size = align(width, height);
+
+		return vs::config(size.width, size.height, Format, Mod);
+	}
+};
+
+/* bo parameters of a buffer fully known at compile time */
+template <uint32_t Format, uint64_t Mod, uint32_t Width, uint32_t Height>
+inline constexpr bo_config bo_config_v = layout<Format, Mod>::config(Width, Height);
+
+/*
+ * Compare the compile time layout of a buffer with the one of
+ * drm_vs_get_align_size and drm_vs_bo_config_ext.
+ * Return true if they are identical.
+ */
+inline bool check_against_c(uint32_t width, uint32_t height, uint32_t format, uint64_t mod)
+{
+	extent size = aligned_size(width, height, format, mod);
+	bo_config cfg = {};
+	drm_vs_bo_param bo_param[4];
+	uint64_t modifiers[4];
+	int ret;
+
+	drm_vs_get_align_size(&width, &height, format, mod);
+	if (size.width != width || size.height != height)
+		return false;
+
+	cfg = config(width, height, format, mod);
+	ret = drm_vs_bo_config_ext(width, height, format, mod, bo_param, modifiers);
+	if (ret != cfg.ret)
+		return false;
+	if (ret)
+		return true;
+
+	for (uint32_t i = 0; i < 4; i++) {
+		if (bo_param[i].width != cfg.plane[i].width ||
+		    bo_param[i].height != cfg.plane[i].height || bo_param[i].bpp != cfg.plane[i].bpp ||
+		    bo_param[i].header_size != cfg.plane[i].header_size ||
+		    bo_param[i].ts_buf_size != cfg.plane[i].ts_buf_size ||
+		    modifiers[i] != cfg.plane[i].modifier)
+			return false;
+	}
+
+	return true;
+}
+} /* namespace vs */
+
+#endif /* __VS_BO_LAYOUT_HPP__ */
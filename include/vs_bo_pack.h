@@ -0,0 +1,118 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef __VS_BO_PACK_H__
+#define __VS_BO_PACK_H__
+
+#include <stdint.h>
+
+#include "vs_bo_helper.h"
+
+/*
+ * Get the standard format drm_vs_pack_custom reads and drm_vs_unpack_custom
+ * writes for the custom layout (DRM_FORMAT_MOD_VS_CUSTOM_FORMAT) of @format:
+ *
+ *   RGB888/BGR888          XRGB8888, into R, G, B or B, G, R planes
+ *   NV12 (10/20 bpp)       P010, 10 bit samples packed low bits first;
+ *                          NV12 with drm_vs_pack_custom_ext, 8 bit samples
+ *                          in the top bits of the 10
+ *   YUV420_10BIT/P016      P010, three 10 bit samples in each 32 bit word
+ *   Y0L0                   luma plane of P010, 10 bits in the low bits
+ *   RGB565_A8/BGR565_A8    ARGB8888, 16 bit RGB565/BGR565 then alpha
+ *
+ * Return the DRM_FORMAT_* of the standard layout, 0 if @format has no
+ * custom layout.
+ */
+uint32_t drm_vs_get_custom_source(uint32_t format);
+
+/*
+ * Pack an image of the standard format of drm_vs_get_custom_source into the
+ * custom layout of @format, plane by plane as drm_vs_get_format_desc reports
+ * it with DRM_FORMAT_MOD_VS_CUSTOM_FORMAT. Pixels past the bytes of a custom
+ * plane row are dropped. The rows use SSSE3 when available, or NEON when
+ * built with PACK_NEON=1, see drm_vs_pack_isa.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*) of the custom layout.
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @src: planes of the standard image.
+ *
+ * @src_pitches: bytes between two rows of each @src plane.
+ *
+ * @dst: planes of the custom layout, e.g. at layout.offsets[i] of
+ *       drm_vs_get_bo_layout.
+ *
+ * @dst_pitches: bytes between two rows of each @dst plane, e.g.
+ *               layout.pitches[i].
+ *
+ * Return 0 on success, -EINVAL for formats without custom layout, missing
+ * planes or pitches too small for the rows.
+ */
+int drm_vs_pack_custom(uint32_t format, uint32_t width, uint32_t height, const void *const src[4],
+		       const uint32_t src_pitches[4], void *const dst[4],
+		       const uint32_t dst_pitches[4]);
+
+/*
+ * Unpack the custom layout of @format into its standard format, the reverse
+ * of drm_vs_pack_custom. Samples are restored to the most significant bits
+ * of P010, or truncated to the top 8 bits for NV12, RGB565 to 8 bits by bit
+ * replication, and the alpha of XRGB8888 is set to 0xff.
+ *
+ * @src: planes of the custom layout.
+ *
+ * @src_pitches: bytes between two rows of each @src plane.
+ *
+ * @dst: planes of the standard image.
+ *
+ * @dst_pitches: bytes between two rows of each @dst plane.
+ *
+ * Other parameters and return value as drm_vs_pack_custom.
+ */
+int drm_vs_unpack_custom(uint32_t format, uint32_t width, uint32_t height,
+			 const void *const src[4], const uint32_t src_pitches[4],
+			 void *const dst[4], const uint32_t dst_pitches[4]);
+
+/*
+ * drm_vs_pack_custom and drm_vs_unpack_custom from or to the standard format
+ * @source instead of the one of drm_vs_get_custom_source, 0 for that one.
+ * Return -EINVAL if @format has no custom layout for @source, else as
+ * drm_vs_pack_custom.
+ */
+int drm_vs_pack_custom_ext(uint32_t format, uint32_t source, uint32_t width, uint32_t height,
+			   const void *const src[4], const uint32_t src_pitches[4],
+			   void *const dst[4], const uint32_t dst_pitches[4]);
+
+int drm_vs_unpack_custom_ext(uint32_t format, uint32_t source, uint32_t width, uint32_t height,
+			     const void *const src[4], const uint32_t src_pitches[4],
+			     void *const dst[4], const uint32_t dst_pitches[4]);
+
+/* Get the instruction set used by the packers: "ssse3", "neon" or "c". */
+const char *drm_vs_pack_isa(void);
+
+#endif /* __VS_BO_PACK_H__ */
@@ -0,0 +1,151 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef __VS_BO_POOL_H__
+#define __VS_BO_POOL_H__
+
+#include <stdint.h>
+
+#include "vs_bo_helper.h"
+
+/*
+ * Allocation backend of the buffer pool, DRM dumb buffers by default.
+ * Any other implementation, e.g. an in-process fake, can be plugged in.
+ * add_fb and rm_fb are not used by the pool itself.
+ */
+typedef struct drm_vs_bo_backend {
+	/*
+	 * Allocate a buffer of @width x @height at @bpp, as
+	 * DRM_IOCTL_MODE_CREATE_DUMB does. Fill @handle and @size, the bytes
+	 * actually allocated. Return 0 on success, a negative errno otherwise.
+	 */
+	int (*create)(void *priv, uint32_t width, uint32_t height, uint32_t bpp, uint32_t *handle,
+		      uint64_t *size);
+	/* Release a buffer allocated by create. */
+	void (*destroy)(void *priv, uint32_t handle);
+	/*
+	 * Register a frame buffer as DRM_IOCTL_MODE_ADDFB2 does, filling
+	 * @fb->fb_id. Return 0 on success, a negative errno otherwise.
+	 */
+	int (*add_fb)(void *priv, struct drm_mode_fb_cmd2 *fb);
+	/* Remove a frame buffer registered by add_fb. */
+	void (*rm_fb)(void *priv, uint32_t fb_id);
+	void *priv;
+} drm_vs_bo_backend;
+
+typedef struct drm_vs_pool_bo {
+	uint32_t handle;
+	/* bytes of the buffer, at least layout.size */
+	uint64_t size;
+	/* planes in the buffer, see drm_vs_get_bo_layout */
+	drm_vs_bo_layout layout;
+} drm_vs_pool_bo;
+
+typedef struct drm_vs_bo_pool_stats {
+	/* successful drm_vs_bo_pool_alloc calls, and how many reused a buffer */
+	uint64_t allocs;
+	uint64_t reuses;
+	/* backend create/destroy calls */
+	uint64_t creates;
+	uint64_t destroys;
+	/* free buffers kept for reuse */
+	uint64_t cached_bos;
+	uint64_t cached_bytes;
+} drm_vs_bo_pool_stats;
+
+typedef struct drm_vs_bo_pool drm_vs_bo_pool;
+
+/*
+ * Fill @backend with the DRM dumb buffer backend.
+ *
+ * @backend: point to the backend to fill.
+ *
+ * @fd: DRM device file descriptor.
+ */
+void drm_vs_bo_backend_init_drm(drm_vs_bo_backend *backend, int fd);
+
+/*
+ * Get the size class of a buffer of @size bytes, 4KB at least and four
+ * classes per power of two above, so a reused buffer wastes less than 25%.
+ *
+ * @size: bytes needed.
+ */
+uint64_t drm_vs_bo_pool_size_class(uint64_t size);
+
+/*
+ * Create a buffer pool.
+ *
+ * @backend: allocation backend, copied.
+ *
+ * @max_cached: bytes of free buffers kept for reuse, above which freed
+ *              buffers are released to the backend.
+ *
+ * Return the pool, NULL on allocation failure.
+ */
+drm_vs_bo_pool *drm_vs_bo_pool_create(const drm_vs_bo_backend *backend, uint64_t max_cached);
+
+/*
+ * Release all free buffers of @pool and @pool itself. Buffers still in
+ * use are left to the caller.
+ */
+void drm_vs_bo_pool_destroy(drm_vs_bo_pool *pool);
+
+/*
+ * Get a buffer holding all planes of a frame buffer, reusing a free one of
+ * the same size class if any. Tile status and header are included in the
+ * size, the layout being the one of drm_vs_get_bo_layout.
+ *
+ * @pool: the pool.
+ *
+ * @width: frame buffer width, aligned internally by drm_vs_get_align_size.
+ *
+ * @height: frame buffer height, aligned internally by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @bo: point to the buffer to fill.
+ *
+ * Return 0 on success, error of drm_vs_get_bo_layout or of the backend
+ * otherwise.
+ */
+int drm_vs_bo_pool_alloc(drm_vs_bo_pool *pool, uint32_t width, uint32_t height, uint32_t format,
+			 uint64_t mod, drm_vs_pool_bo *bo);
+
+/*
+ * Give a buffer of drm_vs_bo_pool_alloc back to @pool, for reuse by
+ * any layout of the same size class.
+ */
+void drm_vs_bo_pool_free(drm_vs_bo_pool *pool, const drm_vs_pool_bo *bo);
+
+/* Release all free buffers of @pool to the backend. */
+void drm_vs_bo_pool_trim(drm_vs_bo_pool *pool);
+
+/* Get the counters of @pool. */
+void drm_vs_bo_pool_get_stats(drm_vs_bo_pool *pool, drm_vs_bo_pool_stats *stats);
+
+#endif /* __VS_BO_POOL_H__ */
@@ -0,0 +1,144 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef __VS_BO_SWIZZLE_H__
+#define __VS_BO_SWIZZLE_H__
+
+#include <stdint.h>
+
+#include "vs_bo_helper.h"
+
+/*
+ * Copy linear rows of one plane into its tiled layout, for the
+ * uncompressed normal tile modes: TILE_8X8, TILE_8X4, TILE_MODE4X4,
+ * TILE_32X8, TILE_32X8_A, TILE_16X16, TILE_16X4, TILE_32X8_YUVSP8X8,
+ * TILE_16X8_YUVSP8X8, TILE_8X8_UNIT2X2, TILE_8X4_UNIT2X2, the 64x64 super
+ * tiles SUPER_TILED_XMAJOR, SUPER_TILED_XMAJOR_8X4, SUPER_TILED_YMAJOR_4X8
+ * and TILE_8X8_SUPERTILE_X, and LINEAR. Tiles follow
+ * drm_vs_get_tile_geometry, pixels in a tile are stored row by row, UNIT2X2
+ * tiles store 2x2 pixel units row by row. The copy uses AVX2, SSE2 or NEON
+ * when available, see drm_vs_swizzle_isa.
+ *
+ * Bands of whole tile rows can be copied concurrently, e.g. one per
+ * thread with the bands of drm_vs_swizzle_band.
+ *
+ * @src: first pixel of the linear plane.
+ *
+ * @src_pitch: bytes between two rows of @src.
+ *
+ * @dst: first byte of the tiled plane, e.g. at layout.offsets[@plane] of
+ *       drm_vs_get_bo_layout.
+ *
+ * @dst_pitch: bytes per row of the tiled plane, as layout.pitches[@plane].
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @plane: plane index, as bo_param of drm_vs_bo_config.
+ *
+ * @y: first row of the plane to copy, a multiple of the tile height.
+ *
+ * @rows: number of rows, a multiple of the tile height.
+ *
+ * Return 0 on success, -EINVAL for other modifiers, planes of less than
+ * 8 bpp, or rows or plane sizes not matching whole tiles.
+ */
+int drm_vs_swizzle_to_tiled(const void *src, uint32_t src_pitch, void *dst, uint32_t dst_pitch,
+			    uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			    uint32_t plane, uint32_t y, uint32_t rows);
+
+/*
+ * Copy a rectangle of one tiled plane to linear rows, e.g. for
+ * screenshots, writeback or CRC checks, for the tile modes of
+ * drm_vs_swizzle_to_tiled. Only the tiles under @rect are read. With AVX2
+ * or SSE2, aligned parts of @dst are written with streaming stores and
+ * aligned parts of @src read with streaming loads (AVX2), so reading a
+ * write combined mapping of a scanout buffer does not evict the cache.
+ *
+ * @src: first byte of the tiled plane, e.g. at layout.offsets[@plane] of
+ *       drm_vs_get_bo_layout.
+ *
+ * @src_pitch: bytes per row of the tiled plane, as layout.pitches[@plane].
+ *
+ * @dst: linear copy of @rect.
+ *
+ * @dst_pitch: bytes between two rows of @dst.
+ *
+ * @width: aligned width obtained by drm_vs_get_align_size.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @plane: plane index, as bo_param of drm_vs_bo_config.
+ *
+ * @rect: rectangle in pixels of the plane, NULL for the whole plane.
+ *
+ * Return 0 on success, -EINVAL for other modifiers, planes of less than
+ * 8 bpp, plane sizes not matching whole tiles or @rect out of the plane.
+ */
+int drm_vs_swizzle_from_tiled(const void *src, uint32_t src_pitch, void *dst, uint32_t dst_pitch,
+			      uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			      uint32_t plane, const struct drm_vs_rect *rect);
+
+/*
+ * Split the rows of a plane into @num_bands bands of whole tile rows, as
+ * even as possible, for drm_vs_swizzle_to_tiled and
+ * drm_vs_swizzle_from_tiled.
+ *
+ * @height: aligned height obtained by drm_vs_get_align_size.
+ *
+ * @format: 4CC format identifier (DRM_FORMAT_*).
+ *
+ * @mod: the modifier value.
+ *
+ * @plane: plane index.
+ *
+ * @num_bands: number of bands, e.g. threads.
+ *
+ * @band: band index, below @num_bands.
+ *
+ * @y: first row of the band.
+ *
+ * @rows: number of rows of the band, 0 if there are more bands than tile rows.
+ *
+ * Return 0 on success, -EINVAL if the plane is not whole tile rows or
+ * cannot be swizzled.
+ */
+int drm_vs_swizzle_band(uint32_t height, uint32_t format, uint64_t mod, uint32_t plane,
+			uint32_t num_bands, uint32_t band, uint32_t *y, uint32_t *rows);
+
+/* Get the instruction set used by the copies: "avx2", "sse2", "neon" or "c". */
+const char *drm_vs_swizzle_isa(void);
+
+#endif /* __VS_BO_SWIZZLE_H__ */
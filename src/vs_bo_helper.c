@@ -30,8 +30,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
 
+#if defined(__SSE2__) && defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "vs_bo_format_def.h"
 #include "vs_bo_helper.h"
+#include "vs_bo_inline.h"
 
 #define MIN_DS_OUT_SIZE 64
 #define MAX_DS_OUT_SIZE 512
@@ -42,40 +51,11 @@
 #define LTM_CD_FILT_NORM_FRAC_BIT 16
 #define LTM_CD_SLOPE_FRAC_BIT 14
 
-/* align needs to be power of 2 */
-#define UP_ALIGN(x, align) ((x + align - 1) & ~(align - 1))
-
-/* align with non-power of 2 */
-#define ALIGN_NP2(n, align) (((n) + (align)-1) - (((n) + (align)-1) % (align)))
-
-#ifndef fourcc_mod_get_vendor
-#define fourcc_mod_get_vendor(val) (((val) >> 56) & 0xff)
-#endif
-
-#define fourcc_mod_vs_get_type(val) (((val)&DRM_FORMAT_MOD_VS_TYPE_MASK) >> 53)
-#define fourcc_mod_vs_get_tile_mode(val) (uint8_t)((val)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK)
-#define fourcc_mod_vs_is_compressed(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_COMPRESSED ? 1 : 0)
-#define fourcc_mod_vs_is_dec400a(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_DEC400A ? 1 : 0)
-#define fourcc_mod_vs_is_pvric(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_PVRIC ? 1 : 0)
-#define fourcc_mod_vs_is_decnano(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_DECNANO ? 1 : 0)
-#define fourcc_mod_vs_is_etc2(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_ETC2 ? 1 : 0)
-#define fourcc_mod_vs_is_normal(val) \
-	!!(fourcc_mod_vs_get_type(val) == DRM_FORMAT_MOD_VS_TYPE_NORMAL ? 1 : 0)
-
-#define NUM_SUPERBLOCK_LAYOUTS 7
-#define HEADER_SIZE 16
-const int superblock_width[NUM_SUPERBLOCK_LAYOUTS] = { 16, 16, 16, 32, 32, 32, 32 };
-const int superblock_height[NUM_SUPERBLOCK_LAYOUTS] = { 16, 16, 16, 8, 8, 8, 8 };
-
 typedef struct _context {
 	uint32_t current_display;
 	uint32_t display_width[VS_DISPLAY_COUNT];
 	uint32_t display_height[VS_DISPLAY_COUNT];
+	uint32_t display_refresh[VS_DISPLAY_COUNT];
 	uint32_t ds_width[VS_DISPLAY_COUNT];
 	uint32_t ds_height[VS_DISPLAY_COUNT];
 } Context;
@@ -83,12 +63,13 @@ typedef struct _context {
 static Context context = { 0 };
 
 static vs_status _drm_vs_display_size_convert(vs_display_size_type type, uint32_t *width,
-					      uint32_t *height)
+					      uint32_t *height, uint32_t *refresh)
 {
 	vs_status status = VS_STATUS_OK;
 
 	uint32_t width_internal = 0;
 	uint32_t height_internal = 0;
+	uint32_t refresh_internal = 60;
 	if (type > VS_DISPLAY_7680_4320_30) {
 		printf("undefined display size type.\n");
 		status = VS_STATUS_INVALID_ARGUMENTS;
@@ -170,12 +151,38 @@ static vs_status _drm_vs_display_size_convert(vs_display_size_type type, uint32_
 		break;
 	}
 
+	switch (type) {
+	case VS_DISPLAY_1440_3520_120:
+	case VS_DISPLAY_1440_3360_120:
+	case VS_DISPLAY_1920_1080_120:
+	case VS_DISPLAY_2700_2600_120:
+	case VS_DISPLAY_2500_2820_120:
+	case VS_DISPLAY_2340_3404_120:
+	case VS_DISPLAY_3200_1920_120:
+	case VS_DISPLAY_3840_2160_120:
+		refresh_internal = 120;
+		break;
+	case VS_DISPLAY_1440_3520_144:
+	case VS_DISPLAY_2700_2600_144:
+	case VS_DISPLAY_2500_2820_144:
+		refresh_internal = 144;
+		break;
+	case VS_DISPLAY_7680_4320_30:
+		refresh_internal = 30;
+		break;
+	default:
+		break;
+	}
+
 	if (width)
 		*width = width_internal;
 
 	if (height)
 		*height = height_internal;
 
+	if (refresh)
+		*refresh = refresh_internal;
+
 	return status;
 }
 
@@ -229,7 +236,8 @@ vs_status drm_vs_display_set_timing(vs_display_size_type type)
 		return status;
 	}
 
-	_drm_vs_display_size_convert(type, &width, &height);
+	_drm_vs_display_size_convert(type, &width, &height,
+				     &context.display_refresh[context.current_display]);
 
 	context.display_width[context.current_display] = width;
 	context.display_height[context.current_display] = height;
@@ -615,472 +623,416 @@ void drm_vs_get_filter_tap(enum drm_vs_filter_type filter, uint8_t *tap_h, uint8
 		break;
 	}
 }
+
+#define VS_MOD_TYPE_COUNT ((DRM_FORMAT_MOD_VS_TYPE_MASK >> 53) + 1)
+#define VS_TILE_MODE_COUNT (DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK + 1)
+#define VS_FORMAT_HASH_BITS 7
+#define VS_FORMAT_HASH_SIZE (1 << VS_FORMAT_HASH_BITS)
+/*
+ * Perfect hash of the formats of VS_FORMAT_LIST, a format added to the list
+ * which collides fails to build with -Woverride-init, pick another multiplier.
+ */
+#define VS_FORMAT_HASH(format) ((uint32_t)((format) * 0x9E378863u) >> (32 - VS_FORMAT_HASH_BITS))
+
+_Static_assert(DRM_FORMAT_MOD_VS_NORM_MODE_MASK <= DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	       "normal tile modes must fit in the descriptor table");
+
+typedef struct _vs_format_desc {
+	uint32_t format;
+	uint8_t fmt_class;
+	vs_layout_desc layout[VS_LAYOUT_COUNT];
+} vs_format_desc;
+
+/* descriptor of one (modifier family, tile mode, format class) */
+typedef struct _vs_mod_desc {
+	/* alignment - 1, in pixels */
+	uint16_t align_w_mask;
+	uint16_t align_h_mask;
+	/* number of planes with known tile height */
+	uint8_t tile_planes;
+	uint8_t tile_height[3];
+} vs_mod_desc;
+
+/* fixed rate compressed block, see VS_BLOCK_LIST */
+typedef struct _vs_block_desc {
+	uint8_t width;
+	uint8_t height;
+	/* compression ratio, 0 for the bytes of VS_ETC2_FORMAT_LIST */
+	uint8_t ratio;
+} vs_block_desc;
+
+/* memory order of a tile mode, see VS_FETCH_ORDER_LIST */
+typedef struct _vs_fetch_order {
+	uint8_t tile_w;
+	uint8_t tile_h;
+	uint8_t y_major;
+	uint8_t group;
+} vs_fetch_order;
+
+typedef struct _vs_chroma_mod_rule {
+	uint32_t format;
+	uint8_t tile_mode;
+	uint8_t chroma_tile_mode;
+} vs_chroma_mod_rule;
+
+#define VS_FORMAT_ENTRY(fmt, cls, std, custom, dec400a) \
+	{ DRM_FORMAT_##fmt, VS_FORMAT_CLASS_##cls, { std, custom, dec400a } },
+#define VS_FORMAT_INDEX_ENTRY(fmt, cls, std, custom, dec400a) VS_FORMAT_INDEX_##fmt,
+#define VS_FORMAT_HASH_ENTRY(fmt, cls, std, custom, dec400a) \
+	[VS_FORMAT_HASH(DRM_FORMAT_##fmt)] = VS_FORMAT_INDEX_##fmt,
+#define VS_MOD_TYPE_ENTRY(type, family) \
+	[DRM_FORMAT_MOD_VS_TYPE_##type] = VS_MOD_FAMILY_##family,
+/* format classes a rule applies to, all of them for ANY */
+#define VS_CLASS_FIRST(cls) \
+	(VS_FORMAT_CLASS_##cls == VS_FORMAT_CLASS_ANY ? 0 : VS_FORMAT_CLASS_##cls)
+#define VS_CLASS_LAST(cls)                                                          \
+	(VS_FORMAT_CLASS_##cls == VS_FORMAT_CLASS_ANY ? VS_FORMAT_CLASS_COUNT - 1 : \
+							VS_FORMAT_CLASS_##cls)
+#define VS_MOD_DESC(family, tile, cls) \
+	[family][DRM_FORMAT_MOD_VS_##tile][VS_CLASS_FIRST(cls) ... VS_CLASS_LAST(cls)]
+#define VS_ALIGN_MASKS(family, tile, cls, w, h)                  \
+	VS_MOD_DESC(family, tile, cls).align_w_mask = (w) - 1, \
+	VS_MOD_DESC(family, tile, cls).align_h_mask = (h) - 1,
+/* DEC400A and unknown modifier types are aligned as normal ones */
+#define VS_ALIGN_ALIAS(fam, alias) \
+	(VS_MOD_FAMILY_##fam == VS_MOD_FAMILY_NORMAL ? VS_MOD_FAMILY_##alias : VS_MOD_FAMILY_##fam)
+#define VS_ALIGN_ENTRY(fam, tile, cls, w, h)                            \
+	VS_ALIGN_MASKS(VS_MOD_FAMILY_##fam, tile, cls, w, h)            \
+	VS_ALIGN_MASKS(VS_ALIGN_ALIAS(fam, DEC400A), tile, cls, w, h) \
+	VS_ALIGN_MASKS(VS_ALIGN_ALIAS(fam, OTHER), tile, cls, w, h)
+#define VS_TILE_HEIGHT_ENTRY(fam, tile, cls, planes, h0, h1, h2)                \
+	VS_MOD_DESC(VS_MOD_FAMILY_##fam, tile, cls).tile_planes = planes, \
+	VS_MOD_DESC(VS_MOD_FAMILY_##fam, tile, cls).tile_height = { h0, h1, h2 },
+#define VS_DEC_TILE_ENTRY(tile, pixels) [DRM_FORMAT_MOD_VS_##tile] = pixels,
+#define VS_PVRIC_TILE_ENTRY(tile, height) [DRM_FORMAT_MOD_VS_##tile] = height,
+#define VS_BLOCK_ENTRY(fam, tile, w, h, ratio) \
+	[VS_MOD_FAMILY_##fam][DRM_FORMAT_MOD_VS_##tile] = { w, h, ratio },
+#define VS_ETC2_FORMAT_ENTRY(fmt, bytes) { DRM_FORMAT_##fmt, bytes },
+#define VS_TILE_GEOMETRY_ENTRY(fam, tile, w, h) \
+	[VS_MOD_FAMILY_##fam][DRM_FORMAT_MOD_VS_##tile] = { w, h },
+#define VS_FETCH_ORDER_ENTRY(fam, tile, w, h, y_major, group) \
+	[VS_MOD_FAMILY_##fam][DRM_FORMAT_MOD_VS_##tile] = { w, h, y_major, group },
+#define VS_CHROMA_MOD_ENTRY(fmt, tile, chroma_tile) \
+	{ DRM_FORMAT_##fmt, DRM_FORMAT_MOD_VS_##tile, DRM_FORMAT_MOD_VS_##chroma_tile },
+#define VS_DEC_TS_8BIT_ENTRY(tile) [DRM_FORMAT_MOD_VS_##tile] = true,
+#define VS_DEC400A_SUPERBLOCK_ENTRY(fmt, w, h) { DRM_FORMAT_##fmt, w, h },
+#define VS_PVRIC_LOSSY_ENTRY(fmt, bytes) { DRM_FORMAT_##fmt, bytes },
+
+/* index of each format in vs_format_tab */
+enum { VS_FORMAT_INDEX_NONE, VS_FORMAT_LIST(VS_FORMAT_INDEX_ENTRY) };
+
+/* entry 0 describes the formats missing from the list */
+static const vs_format_desc vs_format_tab[] = {
+	{ 0, VS_FORMAT_CLASS_DEFAULT, { VS_PLANES_DEFAULT, VS_PLANES_NONE, VS_PLANES_DEFAULT } },
+	VS_FORMAT_LIST(VS_FORMAT_ENTRY)
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Woverride-init"
+static const uint8_t vs_format_hash[VS_FORMAT_HASH_SIZE] = { VS_FORMAT_LIST(VS_FORMAT_HASH_ENTRY) };
+
+/* below, the entries of a list override the defaults and the ANY rules before them */
+#pragma GCC diagnostic ignored "-Woverride-init"
+static const uint8_t vs_mod_family_tab[VS_MOD_TYPE_COUNT] = {
+	[0 ... VS_MOD_TYPE_COUNT - 1] = VS_MOD_FAMILY_OTHER,
+	VS_MOD_TYPE_LIST(VS_MOD_TYPE_ENTRY)
+};
+
+static const vs_mod_desc vs_mod_desc_tab[VS_MOD_FAMILY_COUNT][VS_TILE_MODE_COUNT]
+					[VS_FORMAT_CLASS_COUNT] = {
+	VS_ALIGN_LIST(VS_ALIGN_ENTRY)
+	VS_TILE_HEIGHT_LIST(VS_TILE_HEIGHT_ENTRY)
+};
+
+static const uint8_t vs_pvric_tile_height[256] = {
+	[0 ... 255] = 1,
+	VS_PVRIC_TILE_LIST(VS_PVRIC_TILE_ENTRY)
+};
+#pragma GCC diagnostic pop
+
+static const uint16_t vs_dec_tile_pixels[256] = { VS_DEC_TILE_LIST(VS_DEC_TILE_ENTRY) };
+
+static const vs_block_desc vs_block_tab[VS_MOD_FAMILY_COUNT][VS_TILE_MODE_COUNT] = {
+	VS_BLOCK_LIST(VS_BLOCK_ENTRY)
+};
+
+static const uint32_t vs_etc2_format_tab[][2] = { VS_ETC2_FORMAT_LIST(VS_ETC2_FORMAT_ENTRY) };
+
+static const bool vs_dec_ts_8bit[256] = { VS_DEC_TS_8BIT_LIST(VS_DEC_TS_8BIT_ENTRY) };
+
+static const uint32_t vs_dec400a_superblock_tab[][3] = { VS_DEC400A_SUPERBLOCK_LIST(
+	VS_DEC400A_SUPERBLOCK_ENTRY) };
+
+static const uint32_t vs_pvric_lossy_tab[][2] = { VS_PVRIC_LOSSY_LIST(VS_PVRIC_LOSSY_ENTRY) };
+
+static const vs_chroma_mod_rule vs_chroma_mod_rules[] = { VS_CHROMA_MOD_LIST(
+	VS_CHROMA_MOD_ENTRY) };
+
+/* tile width and height in pixels, 0 if unknown */
+static const uint16_t vs_tile_geometry[VS_MOD_FAMILY_COUNT][VS_TILE_MODE_COUNT][2] = {
+	VS_TILE_GEOMETRY_LIST(VS_TILE_GEOMETRY_ENTRY)
+};
+
+static const vs_fetch_order vs_fetch_order_tab[VS_MOD_FAMILY_COUNT][VS_TILE_MODE_COUNT] = {
+	VS_FETCH_ORDER_LIST(VS_FETCH_ORDER_ENTRY)
+};
+
+static const uint8_t vs_mod_family_tile_mask[VS_MOD_FAMILY_COUNT] = {
+	[VS_MOD_FAMILY_NORMAL] = DRM_FORMAT_MOD_VS_NORM_MODE_MASK,
+	[VS_MOD_FAMILY_DEC400] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	[VS_MOD_FAMILY_DEC400A] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	[VS_MOD_FAMILY_PVRIC] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	[VS_MOD_FAMILY_DECNANO] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	[VS_MOD_FAMILY_ETC2] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+	[VS_MOD_FAMILY_OTHER] = DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK,
+};
+
+#undef VS_FORMAT_ENTRY
+#undef VS_FORMAT_INDEX_ENTRY
+#undef VS_FORMAT_HASH_ENTRY
+#undef VS_MOD_TYPE_ENTRY
+#undef VS_CLASS_FIRST
+#undef VS_CLASS_LAST
+#undef VS_MOD_DESC
+#undef VS_ALIGN_MASKS
+#undef VS_ALIGN_ALIAS
+#undef VS_ALIGN_ENTRY
+#undef VS_TILE_HEIGHT_ENTRY
+#undef VS_DEC_TILE_ENTRY
+#undef VS_PVRIC_TILE_ENTRY
+#undef VS_BLOCK_ENTRY
+#undef VS_ETC2_FORMAT_ENTRY
+#undef VS_TILE_GEOMETRY_ENTRY
+#undef VS_FETCH_ORDER_ENTRY
+#undef VS_CHROMA_MOD_ENTRY
+#undef VS_DEC_TS_8BIT_ENTRY
+#undef VS_DEC400A_SUPERBLOCK_ENTRY
+#undef VS_PVRIC_LOSSY_ENTRY
+
+static inline const vs_format_desc *_vs_find_format(uint32_t format)
+{
+	const vs_format_desc *desc = &vs_format_tab[vs_format_hash[VS_FORMAT_HASH(format)]];
+
+	return desc->format == format ? desc : &vs_format_tab[0];
+}
+
+static inline vs_mod_family _vs_get_mod_family(uint64_t mod)
+{
+	return (vs_mod_family)vs_mod_family_tab[fourcc_mod_vs_get_type(mod)];
+}
+
+static inline vs_layout_variant _vs_get_layout_variant(uint64_t mod)
+{
+	if (fourcc_mod_vs_is_dec400a(mod))
+		return VS_LAYOUT_DEC400A;
+
+	return fourcc_mod_is_custom_format(mod) ? VS_LAYOUT_CUSTOM : VS_LAYOUT_STANDARD;
+}
+
+static inline const vs_mod_desc *_vs_get_mod_desc(const vs_format_desc *fmt, vs_mod_family family,
+						   uint8_t tile_mode)
+{
+	return &vs_mod_desc_tab[family][tile_mode][fmt->fmt_class];
+}
+
 static int _vs_get_format_info(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
 			       uint32_t *num_planes, drm_vs_bo_param bo_param[4])
 {
-	if (fourcc_mod_vs_get_type(mod) == DRM_FORMAT_MOD_VS_TYPE_DEC400A) {
-		switch (format) {
-		case DRM_FORMAT_YUV420_8BIT:
-			*num_planes = 1;
-			bo_param[0].width = width;
-			bo_param[0].height = height;
-			bo_param[0].bpp = 12;
-			break;
-		case DRM_FORMAT_YUV420_10BIT:
-			*num_planes = 1;
-			bo_param[0].width = width;
-			bo_param[0].height = height;
-			bo_param[0].bpp = 24;
-			break;
-		default:
-			*num_planes = 1;
-			bo_param[0].width = width;
-			bo_param[0].height = height;
-			bo_param[0].bpp = 32;
-		}
-	} else {
-		if (fourcc_mod_is_custom_format(mod)) {
-			switch (format) {
-			case DRM_FORMAT_NV12:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 10;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height / 2;
-				bo_param[1].bpp = 20;
-				break;
-			case DRM_FORMAT_YUV444:
-				*num_planes = 3;
-				bo_param[0].width = bo_param[1].width = bo_param[2].width = width;
-				bo_param[0].height = bo_param[1].height = bo_param[2].height =
-					height;
-				bo_param[0].bpp = bo_param[1].bpp = bo_param[2].bpp = 10;
-				break;
-			case DRM_FORMAT_RGB888:
-			case DRM_FORMAT_BGR888:
-				*num_planes = 3;
-				bo_param[0].width = bo_param[1].width = bo_param[2].width = width;
-				bo_param[0].height = bo_param[1].height = bo_param[2].height =
-					height;
-				bo_param[0].bpp = bo_param[1].bpp = bo_param[2].bpp = 8;
-				break;
-			case DRM_FORMAT_RGB565_A8:
-			case DRM_FORMAT_BGR565_A8:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 24;
-				break;
-			case DRM_FORMAT_P010:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height / 2;
-				bo_param[1].bpp = 32;
-				break;
-			case DRM_FORMAT_P210:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height;
-				bo_param[1].bpp = 32;
-				break;
-			case DRM_FORMAT_YVU420:
-			case DRM_FORMAT_YUV420:
-				*num_planes = 3;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				bo_param[1].width = bo_param[2].width = width / 2;
-				bo_param[1].height = bo_param[2].height = height / 2;
-				bo_param[1].bpp = bo_param[2].bpp = 16;
-				break;
-			case DRM_FORMAT_YUV420_10BIT:
-			case DRM_FORMAT_P016:
-				*num_planes = 2;
-				bo_param[0].width = width / 3;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 32;
-				bo_param[1].width = width / 6;
-				bo_param[1].height = height / 2;
-				bo_param[1].bpp = 64;
-				break;
-			/* LUMA_10 */
-			case DRM_FORMAT_Y0L0:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				break;
-			default:
-				fprintf(stderr, "unsupported format %u for mod: %lx \n", format,
-					mod);
-				return -1;
-			}
-		} else {
-			switch (format) {
-			case DRM_FORMAT_XRGB4444:
-			case DRM_FORMAT_XBGR4444:
-			case DRM_FORMAT_RGBX4444:
-			case DRM_FORMAT_BGRX4444:
-			case DRM_FORMAT_ARGB4444:
-			case DRM_FORMAT_ABGR4444:
-			case DRM_FORMAT_RGBA4444:
-			case DRM_FORMAT_BGRA4444:
-			case DRM_FORMAT_XRGB1555:
-			case DRM_FORMAT_XBGR1555:
-			case DRM_FORMAT_RGBX5551:
-			case DRM_FORMAT_BGRX5551:
-			case DRM_FORMAT_ARGB1555:
-			case DRM_FORMAT_ABGR1555:
-			case DRM_FORMAT_RGBA5551:
-			case DRM_FORMAT_BGRA5551:
-			case DRM_FORMAT_RGB565:
-			case DRM_FORMAT_BGR565:
-			case DRM_FORMAT_YUYV:
-			case DRM_FORMAT_YVYU:
-			case DRM_FORMAT_UYVY:
-			case DRM_FORMAT_VYUY:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				break;
-			case DRM_FORMAT_RGB888:
-			case DRM_FORMAT_BGR888:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 24;
-				break;
-			case DRM_FORMAT_ARGB16161616F:
-			case DRM_FORMAT_ABGR16161616F:
-			case DRM_FORMAT_XRGB16161616F:
-			case DRM_FORMAT_XBGR16161616F:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 64;
-				break;
-			case DRM_FORMAT_NV12:
-			case DRM_FORMAT_NV21:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 8;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height / 2;
-				bo_param[1].bpp = 16;
-				break;
-			case DRM_FORMAT_NV16:
-			case DRM_FORMAT_NV61:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 8;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height;
-				bo_param[1].bpp = 16;
-				break;
-			case DRM_FORMAT_P010:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height / 2;
-				bo_param[1].bpp = 32;
-				break;
-			case DRM_FORMAT_P210:
-				*num_planes = 2;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 16;
-				bo_param[1].width = width / 2;
-				bo_param[1].height = height;
-				bo_param[1].bpp = 32;
-				break;
-			case DRM_FORMAT_YVU420:
-			case DRM_FORMAT_YUV420:
-				*num_planes = 3;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 8;
-				bo_param[1].width = bo_param[2].width = width / 2;
-				bo_param[1].height = bo_param[2].height = height / 2;
-				bo_param[1].bpp = bo_param[2].bpp = 8;
-				break;
-			case DRM_FORMAT_YUV444:
-			case DRM_FORMAT_YVU444:
-				*num_planes = 3;
-				bo_param[0].width = bo_param[1].width = bo_param[2].width = width;
-				bo_param[0].height = bo_param[1].height = bo_param[2].height =
-					height;
-				bo_param[0].bpp = bo_param[1].bpp = bo_param[2].bpp = 8;
-				break;
-			case DRM_FORMAT_C8:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 8;
-				break;
-			default:
-				*num_planes = 1;
-				bo_param[0].width = width;
-				bo_param[0].height = height;
-				bo_param[0].bpp = 32;
-			}
-		}
+	const vs_layout_desc *layout = &_vs_find_format(format)->layout[_vs_get_layout_variant(mod)];
+	uint32_t i;
+
+	if (!layout->num_planes) {
+		fprintf(stderr, "unsupported format %u for mod: %lx \n", format, mod);
+		return -EINVAL;
+	}
+
+	*num_planes = layout->num_planes;
+	for (i = 0; i < layout->num_planes; i++) {
+		bo_param[i].width = width / layout->plane[i].width_div;
+		bo_param[i].height = height / layout->plane[i].height_div;
+		bo_param[i].bpp = layout->plane[i].bpp;
 	}
 
 	return 0;
 }
 
-int vs_mod_config(uint32_t format, uint64_t mod, uint32_t num_planes, uint64_t modifiers[4])
+int drm_vs_get_format_desc(uint32_t format, uint64_t mod, drm_vs_format_desc *desc)
 {
+	const vs_format_desc *fmt = _vs_find_format(format);
+	const vs_layout_desc *layout = &fmt->layout[_vs_get_layout_variant(mod)];
+	vs_mod_family family = _vs_get_mod_family(mod);
+	const vs_mod_desc *align, *tile;
 	uint32_t i;
 
-	if (fourcc_mod_vs_is_compressed(mod)) {
-		switch (format) {
-		case DRM_FORMAT_NV12:
-		case DRM_FORMAT_NV21:
-			switch (fourcc_mod_vs_get_tile_mode(mod)) {
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_256X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_128X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_64X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_32X8:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_32X4,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_16X8:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_16X4,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_32X8_YUVSP8X8:
-				modifiers[0] = mod;
-				modifiers[1] = fourcc_mod_vs_dec_code(
-					DRM_FORMAT_MOD_VS_DEC_TILE_32X4_YUVSP8X8,
-					DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			default:
-				fprintf(stderr, "unsupported mod%lx for NV12\n", mod);
-				return -1;
-			}
-			break;
-		case DRM_FORMAT_P010:
-		case DRM_FORMAT_P210:
-			switch (fourcc_mod_vs_get_tile_mode(mod)) {
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_64X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_64X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_32X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_16X8:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_16X4,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_XMAJOR:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_8X4,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_TILE_16X8_YUVSP8X8:
-				modifiers[0] = mod;
-				modifiers[1] = fourcc_mod_vs_dec_code(
-					DRM_FORMAT_MOD_VS_DEC_TILE_16X4_YUVSP8X8,
-					DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			default:
-				fprintf(stderr, "unsupported mod%lx for P010\n", mod);
-				return -1;
-			}
-			break;
-		case DRM_FORMAT_NV16:
-		case DRM_FORMAT_NV61:
-			switch (fourcc_mod_vs_get_tile_mode(mod)) {
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_256X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_128X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-				modifiers[0] = mod;
-				modifiers[1] =
-					fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_RASTER_64X1,
-							       DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
-				break;
-			default:
-				fprintf(stderr, "unsupported mod%lx for NV16\n", mod);
-				return -1;
-			}
-			break;
-		default:
-			for (i = 0; i < num_planes; i++)
-				modifiers[i] = mod;
-		}
-	} else {
-		for (i = 0; i < num_planes; i++)
-			modifiers[i] = mod;
+	if (!desc)
+		return -EINVAL;
+
+	memset(desc, 0, sizeof(*desc));
+
+	if (!layout->num_planes)
+		return -EINVAL;
+
+	align = _vs_get_mod_desc(fmt, family, fourcc_mod_vs_get_tile_mode(mod));
+	tile = _vs_get_mod_desc(fmt, family, mod & vs_mod_family_tile_mask[family]);
+
+	desc->num_planes = layout->num_planes;
+	for (i = 0; i < layout->num_planes; i++) {
+		desc->bpp[i] = layout->plane[i].bpp;
+		desc->hsub[i] = layout->plane[i].width_div;
+		desc->vsub[i] = layout->plane[i].height_div;
 	}
+	desc->align_width = align->align_w_mask + 1;
+	desc->align_height = align->align_h_mask + 1;
+	for (i = 0; i < tile->tile_planes; i++)
+		desc->tile_height[i] = tile->tile_height[i];
 
 	return 0;
 }
 
-uint16_t vs_get_dec_tile_size(uint8_t tile_mode, uint8_t bpp)
+/*
+ * Chroma rule of a DEC400 compressed format, NULL if there is none.
+ * @listed tells whether the format has rules for other tile modes.
+ */
+static const vs_chroma_mod_rule *_vs_find_chroma_rule(uint32_t format, uint8_t tile_mode,
+						      bool *listed)
 {
-	uint16_t multi = 0;
+	const vs_chroma_mod_rule *rule;
+	uint32_t i;
 
-	switch (tile_mode) {
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_16X1:
-		multi = 16;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X4:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_4X8:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_32X1:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X4_S:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X4_UNIT2X2:
-		multi = 32;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_XMAJOR:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_YMAJOR:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_UNIT2X2:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_SUPERTILE_X:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_16X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_64X1:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_32X2:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X4_S:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X4_LSB:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X4_YUVSP8X8:
-		multi = 64;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X8:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X16:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_32X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_64X2:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X4_S:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X4_LSB:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X4_YUVSP8X8:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X8_YUVSP8X8:
-		multi = 128;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_64X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_256X1:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_64X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_128X2:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X16:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X8:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X8_YUVSP8X8:
-		multi = 256;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_256X2:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_128X4:
-	case DRM_FORMAT_MOD_VS_DEC_RASTER_512X1:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_128X4:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X16:
-		multi = 512;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_256X4:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_64X16:
-	case DRM_FORMAT_MOD_VS_DEC_TILE_128X8:
-		multi = 1024;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_512X4:
-		multi = 2048;
-		break;
-	default:
-		break;
+	*listed = false;
+	for (i = 0; i < sizeof(vs_chroma_mod_rules) / sizeof(vs_chroma_mod_rules[0]); i++) {
+		rule = &vs_chroma_mod_rules[i];
+		if (rule->format != format)
+			continue;
+
+		*listed = true;
+		if (rule->tile_mode == tile_mode)
+			return rule;
 	}
 
-	return multi * bpp / 8;
+	return NULL;
 }
 
-static uint16_t _vs_get_pvric_tile_height(uint8_t tile_mode)
+/* bytes of one ETC2 block of @format, 0 if ETC2 does not support it */
+static uint32_t _vs_get_etc2_block_bytes(uint32_t format)
 {
-	uint16_t height = 1;
+	uint32_t i;
 
-	switch (tile_mode) {
-	case DRM_FORMAT_MOD_VS_DEC_TILE_8X8:
-		height = 8;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_16X4:
-		height = 4;
-		break;
-	case DRM_FORMAT_MOD_VS_DEC_TILE_32X2:
-		height = 2;
-		break;
-	default:
-		break;
+	for (i = 0; i < sizeof(vs_etc2_format_tab) / sizeof(vs_etc2_format_tab[0]); i++) {
+		if (vs_etc2_format_tab[i][0] == format)
+			return vs_etc2_format_tab[i][1];
 	}
 
-	return height;
+	return 0;
 }
 
-static uint32_t _vs_get_ts_buf_size(uint32_t buf_size, uint16_t tile_size, uint8_t tile_mode)
+/* bytes of one DECNano/ETC2 block of a @bpp plane of @format, 0 if unsupported */
+static uint32_t _vs_get_block_bytes(vs_mod_family family, uint8_t tile_mode, uint32_t format,
+				    uint8_t bpp)
 {
-	uint32_t ts_size = 0;
+	const vs_block_desc *block = &vs_block_tab[family][tile_mode];
 
-	if (tile_mode == DRM_FORMAT_MOD_VS_DEC_TILE_8X8_UNIT2X2 ||
-	    tile_mode == DRM_FORMAT_MOD_VS_DEC_TILE_8X4_UNIT2X2) {
-		/*
-		 * 8-bit tile status
-		 * for compression unit size = 256 bytes, ts_size = buf_size / 256
-		 */
-		ts_size = UP_ALIGN(buf_size, 256) / 256;
-	} else {
-		/*
-		 * 4-bit tile status
-		 * for compression unit size = 256 bytes, ts_size = buf_size / 256 / 2
-		 * for compression unit size = 128 bytes, ts_size = buf_size / 128 / 2
-		 */
-		ts_size = UP_ALIGN(buf_size, 512) / 512;
+	if (!block->width)
+		return 0;
+
+	if (!block->ratio)
+		return _vs_get_etc2_block_bytes(format);
+
+	return block->width * block->height * bpp / 8 / block->ratio;
+}
+
+/* modifier of each plane, as vs_mod_config but without reporting unsupported pairs */
+static int _vs_get_plane_mods(uint32_t format, uint64_t mod, uint32_t num_planes,
+			      uint64_t modifiers[4])
+{
+	const vs_chroma_mod_rule *rule;
+	bool listed;
+	uint32_t i;
+
+	if (fourcc_mod_vs_is_compressed(mod)) {
+		rule = _vs_find_chroma_rule(format, fourcc_mod_vs_get_tile_mode(mod), &listed);
+		if (rule) {
+			modifiers[0] = mod;
+			modifiers[1] = fourcc_mod_vs_dec_code(rule->chroma_tile_mode,
+							      DRM_FORMAT_MOD_VS_DEC_ALIGN_32);
+			return 0;
+		}
+
+		if (listed)
+			return -EINVAL;
+	}
+
+	for (i = 0; i < num_planes; i++)
+		modifiers[i] = mod;
+
+	return 0;
+}
+
+int vs_mod_config(uint32_t format, uint64_t mod, uint32_t num_planes, uint64_t modifiers[4])
+{
+	int ret = _vs_get_plane_mods(format, mod, num_planes, modifiers);
+
+	if (ret)
+		fprintf(stderr, "unsupported mod%lx for %.4s\n", mod, (const char *)&format);
+
+	return ret;
+}
+
+uint16_t vs_get_dec_tile_size(uint8_t tile_mode, uint8_t bpp)
+{
+	return vs_dec_tile_pixels[tile_mode] * bpp / 8;
+}
+
+static uint16_t _vs_get_pvric_tile_height(uint8_t tile_mode)
+{
+	return vs_pvric_tile_height[tile_mode];
+}
+
+/* DEC400A superblock of @format in pixels, @height may be NULL */
+static void _vs_get_dec400a_superblock(uint32_t format, uint32_t *width, uint32_t *height)
+{
+	uint32_t i, w = VS_DEC400A_SUPERBLOCK_W, h = VS_DEC400A_SUPERBLOCK_H;
 
-		if (tile_size == 128)
-			ts_size = ts_size << 1;
+	for (i = 0; i < sizeof(vs_dec400a_superblock_tab) / sizeof(vs_dec400a_superblock_tab[0]);
+	     i++) {
+		if (vs_dec400a_superblock_tab[i][0] == format) {
+			w = vs_dec400a_superblock_tab[i][1];
+			h = vs_dec400a_superblock_tab[i][2];
+			break;
+		}
 	}
 
-	return ts_size;
+	*width = w;
+	if (height)
+		*height = h;
 }
 
-static void _vs_cal_bo_size(drm_vs_bo_param bo_param[4], uint64_t modifiers[4], uint32_t format,
-			    uint32_t num_planes)
+/* bytes of one lossy PVRIC tile of @format, see VS_PVRIC_LOSSY_LIST */
+static uint32_t _vs_get_pvric_lossy_bytes(uint32_t format)
 {
 	uint32_t i;
 
-	for (i = 0; i < num_planes; i++) {
-		drm_vs_calibrate_bo_size(&bo_param[i], modifiers[i], format);
+	for (i = 0; i < sizeof(vs_pvric_lossy_tab) / sizeof(vs_pvric_lossy_tab[0]); i++) {
+		if (vs_pvric_lossy_tab[i][0] == format)
+			return vs_pvric_lossy_tab[i][1];
 	}
+
+	return VS_PVRIC_LOSSY_BYTES;
+}
+
+/* DEC400 tile modes with one tile status byte per tile, others have 4 bits */
+static bool _vs_dec_ts_is_8bit(uint8_t tile_mode)
+{
+	return vs_dec_ts_8bit[tile_mode];
+}
+
+static uint64_t _vs_get_ts_buf_size(uint64_t buf_size, uint16_t tile_size, uint8_t tile_mode)
+{
+	/*
+	 * 8-bit tile status: one byte per 256 bytes
+	 * 4-bit tile status: one nibble per 256 or 128 bytes compression unit
+	 */
+	return VS_DEC_TS_SIZE(buf_size, tile_size, _vs_dec_ts_is_8bit(tile_mode));
 }
 
 int _drm_vs_eotf_pq(double *value)
@@ -1491,359 +1443,189 @@ int drm_vs_init_degamma_curve(uint32_t in_bit, uint32_t out_bit, uint32_t entry_
 	return 0;
 }
 
-void drm_vs_get_tile_height(uint32_t format, uint64_t mod, int *height)
+/* drm_vs_get_tile_geometry, silent about unsupported pairs if !@report */
+static int _vs_get_tile_geometry(uint32_t format, uint64_t mod, drm_vs_tile_geometry *geometry,
+				 bool report)
 {
+	const vs_format_desc *fmt = _vs_find_format(format);
+	const vs_layout_desc *layout = &fmt->layout[_vs_get_layout_variant(mod)];
+	uint64_t modifiers[4] = { 0 };
+	const vs_block_desc *block;
+	const vs_mod_desc *desc;
+	vs_mod_family family;
+	uint32_t i, width, height, bpp;
 	uint8_t tile_mode;
 
-	if (fourcc_mod_vs_is_normal(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_NORM_MODE_MASK);
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_LINEAR:
-			*height = 1;
-			*(height + 1) = 1;
-			*(height + 2) = 1;
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_16X4:
-			*height = 4; /* TODO: need to add other plane if YUV format is supported */
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_16X8_YUVSP8X8:
-			if (format == DRM_FORMAT_P010) {
-				*height = 8;
-				*(height + 1) = 4;
-			}
+	if (!geometry)
+		return -EINVAL;
+
+	memset(geometry, 0, sizeof(*geometry));
+
+	if (!layout->num_planes)
+		return -EINVAL;
+	if (report ? vs_mod_config(format, mod, layout->num_planes, modifiers) :
+		     _vs_get_plane_mods(format, mod, layout->num_planes, modifiers))
+		return -EINVAL;
+
+	geometry->num_planes = layout->num_planes;
+	for (i = 0; i < layout->num_planes; i++) {
+		/* chroma planes of DEC400 formats have their own tile mode */
+		family = _vs_get_mod_family(modifiers[i]);
+		tile_mode = modifiers[i] & vs_mod_family_tile_mask[family];
+		bpp = layout->plane[i].bpp;
+
+		switch (family) {
+		case VS_MOD_FAMILY_DEC400A:
+			_vs_get_dec400a_superblock(format, &width, &height);
+			geometry->bytes[i] = width * height * bpp / 8;
 			break;
-		case DRM_FORMAT_MOD_VS_TILE_32X8_YUVSP8X8:
-			if (format == DRM_FORMAT_NV12 || format == DRM_FORMAT_NV21) {
-				*height = 8;
-				*(height + 1) = 4;
-			}
+		case VS_MOD_FAMILY_DECNANO:
+		case VS_MOD_FAMILY_ETC2:
+			block = &vs_block_tab[family][tile_mode];
+			width = block->width;
+			height = block->height;
+			geometry->bytes[i] = _vs_get_block_bytes(family, tile_mode, format, bpp);
 			break;
 		default:
+			width = vs_tile_geometry[family][tile_mode][0];
+			height = vs_tile_geometry[family][tile_mode][1];
+
+			/* format specific tile height, e.g. chroma of YUVSP8X8 */
+			desc = _vs_get_mod_desc(fmt, family, tile_mode);
+			if (i < desc->tile_planes && desc->tile_height[i])
+				height = desc->tile_height[i];
+
+			geometry->bytes[i] = width * height * bpp / 8;
 			break;
 		}
-	} else if (fourcc_mod_vs_is_compressed(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_16X1:
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_32X1:
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_64X1:
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_256X1:
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_512X1:
-			*height = 1;
-			*(height + 1) = 1;
-			*(height + 2) = 1;
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_16X8_YUVSP8X8:
-			if (format == DRM_FORMAT_P010) {
-				*height = 8;
-				*(height + 1) = 4;
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_32X8_YUVSP8X8:
-			if (format == DRM_FORMAT_NV12 || format == DRM_FORMAT_NV21) {
-				*height = 8;
-				*(height + 1) = 4;
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_SUPERTILE_X:
-			*height = 64;
-			break;
-		default:
-			break;
+
+		geometry->width[i] = width;
+		geometry->height[i] = height;
+		geometry->inner_width[i] = width;
+		geometry->inner_height[i] = height;
+
+		/* super tiles, see VS_FETCH_ORDER_LIST */
+		if (vs_fetch_order_tab[family][tile_mode].tile_w) {
+			geometry->inner_width[i] = vs_fetch_order_tab[family][tile_mode].tile_w;
+			geometry->inner_height[i] = vs_fetch_order_tab[family][tile_mode].tile_h;
+			geometry->y_major[i] = vs_fetch_order_tab[family][tile_mode].y_major;
 		}
-	} else if (fourcc_mod_vs_is_pvric(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
-	} else if (fourcc_mod_vs_is_decnano(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
-	} else if (fourcc_mod_vs_is_etc2(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
-	} else if (fourcc_mod_vs_is_dec400a(mod)) {
-		tile_mode = (uint8_t)((mod)&DRM_FORMAT_MOD_VS_DEC_TILE_MODE_MASK);
+	}
+
+	return 0;
+}
+
+int drm_vs_get_tile_geometry(uint32_t format, uint64_t mod, drm_vs_tile_geometry *geometry)
+{
+	return _vs_get_tile_geometry(format, mod, geometry, true);
+}
+
+void drm_vs_get_tile_height(uint32_t format, uint64_t mod, int *height)
+{
+	vs_mod_family family = _vs_get_mod_family(mod);
+	drm_vs_tile_geometry geometry;
+	const vs_mod_desc *desc;
+	uint32_t i;
+
+	desc = _vs_get_mod_desc(_vs_find_format(format), family,
+				mod & vs_mod_family_tile_mask[family]);
+
+	if (desc->tile_planes) {
+		for (i = 0; i < desc->tile_planes; i++)
+			height[i] = desc->tile_height[i];
+		return;
+	}
+
+	/* tile modes without explicit rule, leave height untouched if unknown */
+	if (_vs_get_tile_geometry(format, mod, &geometry, false))
+		return;
+
+	for (i = 0; i < geometry.num_planes && i < 3; i++) {
+		if (geometry.height[i])
+			height[i] = geometry.height[i];
 	}
 }
 
 int drm_vs_get_align_size(uint32_t *width, uint32_t *height, uint32_t format, uint64_t mod)
+{
+	const vs_mod_desc *desc;
+
+	desc = _vs_get_mod_desc(_vs_find_format(format), _vs_get_mod_family(mod),
+				fourcc_mod_vs_get_tile_mode(mod));
+
+	*width = (*width + desc->align_w_mask) & ~(uint32_t)desc->align_w_mask;
+	*height = (*height + desc->align_h_mask) & ~(uint32_t)desc->align_h_mask;
+
+	return 0;
+}
+
+static uint64_t _vs_get_dec400a_ts_buf_size(const drm_vs_bo_param64 *bo_param, uint32_t format)
+{
+	uint32_t sb_w, sb_h;
+
+	_vs_get_dec400a_superblock(format, &sb_w, &sb_h);
+
+	return VS_DEC400A_TS_SIZE(bo_param->width, bo_param->height, sb_w, sb_h);
+}
+
+/*
+ * Size calculation of all sub-IPs, in 64-bit so that no intermediate value
+ * wraps. @bo_param->height is the plane height on input and the virtual
+ * height with tile status/header rows on output.
+ */
+static void _vs_calibrate_bo_size64(drm_vs_bo_param64 *bo_param, uint64_t modifier,
+				    uint32_t format)
 {
 	uint8_t tile_mode;
-	uint32_t ori_width = *width;
-	uint32_t ori_height = *height;
+	uint16_t tile_size, tile_height;
+	uint64_t ts_buf_size, stride, tile_cnt, fc_size = 0;
+	uint64_t aligned_area;
+	uint32_t block_bytes;
+	bool lossy;
+	const vs_block_desc *block;
 
-	tile_mode = fourcc_mod_vs_get_tile_mode(mod);
-	if (fourcc_mod_vs_is_compressed(mod)) {
-		/* alignment requirements for dec400 sub-IP */
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_32X1:
-			*width = UP_ALIGN(ori_width, 32);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_64X1:
-			*width = UP_ALIGN(ori_width, 64);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_128X1:
-			*width = UP_ALIGN(ori_width, 128);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_RASTER_256X1:
-			if (format == DRM_FORMAT_YVU420 || format == DRM_FORMAT_YUV420)
-				*width = UP_ALIGN(ori_width, 512);
-			else
-				*width = UP_ALIGN(ori_width, 256);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X4:
-		case DRM_FORMAT_MOD_VS_DEC_TILE_4X8:
-			*width = UP_ALIGN(ori_width, 64);
-			*height = UP_ALIGN(ori_height, 64);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X4_UNIT2X2:
-			*width = UP_ALIGN(ori_width, 8);
-			*height = UP_ALIGN(ori_height, 4);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_UNIT2X2:
-			*width = UP_ALIGN(ori_width, 8);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_XMAJOR:
-			if (format == DRM_FORMAT_YUYV || format == DRM_FORMAT_UYVY ||
-			    format == DRM_FORMAT_P010) {
-				*width = UP_ALIGN(ori_width, 16);
-				*height = UP_ALIGN(ori_height, 8);
-			} else {
-				*width = UP_ALIGN(ori_width, 64);
-				*height = UP_ALIGN(ori_height, 64);
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_16X8:
-		case DRM_FORMAT_MOD_VS_DEC_TILE_32X8:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X8_SUPERTILE_X:
-			*width = UP_ALIGN(ori_width, 64);
-			*height = UP_ALIGN(ori_height, 64);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_32X8_YUVSP8X8:
-			*width = UP_ALIGN(ori_width, 32);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_16X8_YUVSP8X8:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		default:
-			break;
-		}
-	} else if (fourcc_mod_vs_is_pvric(mod)) {
-		/* alignment requirements for PVRIC sub-IP */
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_DEC_TILE_8X8:
-			if (format == DRM_FORMAT_P010) {
-				*width = UP_ALIGN(ori_width, 16);
-				*height = UP_ALIGN(ori_height, 8);
-			} else if (format == DRM_FORMAT_C8) {
-				*width = UP_ALIGN(ori_width, 32);
-				*height = UP_ALIGN(ori_height, 8);
-			} else {
-				*width = UP_ALIGN(ori_width, 32);
-				*height = UP_ALIGN(ori_height, 8);
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_16X4:
-			if (format == DRM_FORMAT_RGB565 || format == DRM_FORMAT_BGR565) {
-				*width = UP_ALIGN(ori_width, 32);
-				*height = UP_ALIGN(ori_height, 4);
-			} else {
-				*width = UP_ALIGN(ori_width, 16);
-				*height = UP_ALIGN(ori_height, 4);
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_32X2:
-			*width = UP_ALIGN(ori_width, 32);
-			*height = UP_ALIGN(ori_height, 2);
-			break;
-		default:
-			break;
-		}
-	} else if (fourcc_mod_vs_is_decnano(mod)) {
-		/* alignment requirements for DECNano sub-IP */
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_DEC_LINEAR:
-			*width = UP_ALIGN(ori_width, 16);
-			break;
-		case DRM_FORMAT_MOD_VS_DEC_TILE_4X4:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 4);
-			break;
-		default:
-			break;
-		}
-	} else if (fourcc_mod_vs_is_etc2(mod)) {
-		/* alignment requirements for ETC2 sub-IP */
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_DEC_TILE_4X4:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 4);
-			break;
-		default:
-			break;
-		}
-	} else {
-		switch (tile_mode) {
-		case DRM_FORMAT_MOD_VS_LINEAR:
-			switch (format) {
-			case DRM_FORMAT_YUYV:
-			case DRM_FORMAT_YVYU:
-			case DRM_FORMAT_UYVY:
-			case DRM_FORMAT_VYUY:
-			case DRM_FORMAT_NV12:
-			case DRM_FORMAT_NV21:
-			case DRM_FORMAT_NV16:
-			case DRM_FORMAT_NV61:
-			case DRM_FORMAT_YVU420:
-			case DRM_FORMAT_YUV420:
-			case DRM_FORMAT_P010:
-			case DRM_FORMAT_P210:
-				*width = UP_ALIGN(ori_width, 2);
-				*height = UP_ALIGN(ori_height, 2);
-				break;
-			case DRM_FORMAT_YUV420_10BIT:
-			case DRM_FORMAT_P016:
-				*width = ALIGN_NP2(ori_width, 2);
-				*height = UP_ALIGN(ori_height, 2);
-				break;
-			case DRM_FORMAT_C8:
-				*width = UP_ALIGN(ori_width, 1);
-				*height = UP_ALIGN(ori_height, 1);
-				break;
-			default:
-				break;
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_8X8:
-		case DRM_FORMAT_MOD_VS_TILE_8X8_UNIT2X2:
-			*width = UP_ALIGN(ori_width, 8);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_8X4:
-		case DRM_FORMAT_MOD_VS_TILE_8X4_UNIT2X2:
-			*width = UP_ALIGN(ori_width, 8);
-			*height = UP_ALIGN(ori_height, 4);
-			break;
-		case DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR:
-		case DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR_8X4:
-		case DRM_FORMAT_MOD_VS_SUPER_TILED_YMAJOR_4X8:
-			*width = UP_ALIGN(ori_width, 64);
-			*height = UP_ALIGN(ori_height, 64);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_MODE4X4:
-			if (format == DRM_FORMAT_NV12 || format == DRM_FORMAT_NV21) {
-				*width = UP_ALIGN(ori_width, 64);
-				*height = UP_ALIGN(ori_height, 4);
-			} else if (format == DRM_FORMAT_YUV444) {
-				*width = UP_ALIGN(ori_width, 32);
-				*height = UP_ALIGN(ori_height, 4);
-			}
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_32X8:
-		case DRM_FORMAT_MOD_VS_TILE_32X8_A:
-			*width = UP_ALIGN(ori_width, 32);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_16X16:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 16);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_16X4:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 4);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_8X8_SUPERTILE_X:
-			*width = UP_ALIGN(ori_width, 64);
-			*height = UP_ALIGN(ori_height, 64);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_32X8_YUVSP8X8:
-			*width = UP_ALIGN(ori_width, 32);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		case DRM_FORMAT_MOD_VS_TILE_16X8_YUVSP8X8:
-			*width = UP_ALIGN(ori_width, 16);
-			*height = UP_ALIGN(ori_height, 8);
-			break;
-		default:
-			break;
-		}
-	}
-
-	return 0;
-}
-
-static uint32_t mb_round(int mb, int q)
-{
-	return (mb / q + ((mb % q) ? 1 : 0)) * q;
-}
-
-static uint32_t _vs_get_dec400a_ts_buf_size(drm_vs_bo_param *bo_param, uint32_t format)
-{
-	int superblock_layout = 0;
-	uint32_t mb_sizew = 0, mb_sizeh = 0, mbw = 0, mbh = 0;
-	uint32_t ts_buffer_size;
-
-	if (format == DRM_FORMAT_ARGB8888 || format == DRM_FORMAT_ARGB2101010) {
-		superblock_layout = 3;
-	} else if (format == DRM_FORMAT_YUV420_8BIT || format == DRM_FORMAT_YUV420_10BIT) {
-		superblock_layout = 5;
-	}
-
-	mb_sizew = superblock_width[superblock_layout];
-	mb_sizeh = superblock_height[superblock_layout];
-	mbw = (bo_param->width + mb_sizew - 1) / mb_sizew;
-	mbh = (bo_param->height + mb_sizeh - 1) / mb_sizeh;
-
-	ts_buffer_size = mb_round(mbw, 1) * mb_round(mbh, 1) * HEADER_SIZE;
-
-	return ts_buffer_size;
-}
-
-void drm_vs_calibrate_bo_size(drm_vs_bo_param *bo_param, uint64_t modifier, uint32_t format)
-{
-	uint8_t tile_mode;
-	uint16_t tile_size, tile_height;
-	uint32_t ts_buf_size, stride, bo_height, tile_cnt, fc_size = 0;
-	uint64_t aligned_area;
-	bool lossy;
+	stride = (uint64_t)bo_param->width * bo_param->bpp / 8;
 
 	if (fourcc_mod_vs_is_compressed(modifier)) {
 		/* buffer size calculation for dec400 sub-IP */
 		tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
 		tile_size = vs_get_dec_tile_size(tile_mode, bo_param->bpp);
-		stride = bo_param->width * bo_param->bpp / 8;
-		aligned_area = ALIGN_NP2(stride, tile_size) * bo_param->height;
+		if (!tile_size || !stride)
+			goto out;
+
+		aligned_area = VS_ALIGN_NP2(stride, (uint64_t)tile_size) * bo_param->height;
 		/* Align ts buf size to stride, so we can get integer height */
-		ts_buf_size = ALIGN_NP2((_vs_get_ts_buf_size(aligned_area, tile_size, tile_mode)),
+		ts_buf_size = VS_ALIGN_NP2((_vs_get_ts_buf_size(aligned_area, tile_size, tile_mode)),
 					stride);
 
 		if (dec_mod_is_fc(modifier))
-			fc_size = 128 + 128 * dec_mod_get_fc_size(modifier);
+			fc_size = VS_DEC_FC_SIZE(dec_mod_get_fc_size(modifier));
 		bo_param->ts_buf_size = ts_buf_size + fc_size;
 
-		/* Get bo_height with tile status buffer */
-		bo_param->height += ts_buf_size / stride;
+		/* Get bo_height with tile status buffer and fast clear area */
+		bo_param->height += VS_ALIGN_NP2(ts_buf_size + fc_size, stride) / stride;
 	} else if (fourcc_mod_vs_is_dec400a(modifier)) {
-		stride = bo_param->width * bo_param->bpp / 8;
+		if (!stride)
+			goto out;
+
 		ts_buf_size = _vs_get_dec400a_ts_buf_size(bo_param, format);
 		bo_param->ts_buf_size = ts_buf_size;
 
 		/* Get bo_height with tile status buffer */
-		bo_param->height += ALIGN_NP2(ts_buf_size, stride) / stride;
+		bo_param->height += VS_ALIGN_NP2(ts_buf_size, stride) / stride;
 	} else if (fourcc_mod_vs_is_pvric(modifier)) {
 		/* buffer size calculation for PVRIC sub-IP */
 		tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
 		tile_height = _vs_get_pvric_tile_height(tile_mode);
-		stride = bo_param->width * bo_param->bpp / 8;
-		aligned_area = UP_ALIGN(stride, 256 / tile_height) * bo_param->height;
+		if (!stride)
+			goto out;
+
+		aligned_area = VS_UP_ALIGN(stride, (uint64_t)(256 / tile_height)) * bo_param->height;
 		tile_cnt = aligned_area / 256;
 		/* Align (header size + data base addr alignment) to stride,
 		 * so we can get integer height
 		 */
-		ts_buf_size = UP_ALIGN(tile_cnt + 256, stride);
+		ts_buf_size = VS_UP_ALIGN(tile_cnt + 256, stride);
 
 		if (modifier & DRM_FORMAT_MOD_VS_DEC_LOSSY)
 			lossy = true;
@@ -1852,26 +1634,294 @@ void drm_vs_calibrate_bo_size(drm_vs_bo_param *bo_param, uint64_t modifier, uint
 
 		if (!lossy)
 			aligned_area += ts_buf_size;
-		else if (format == DRM_FORMAT_P010)
-			aligned_area = ts_buf_size + UP_ALIGN(tile_cnt * 96, stride);
 		else
-			aligned_area = ts_buf_size + UP_ALIGN(tile_cnt * 128, stride);
+			aligned_area = ts_buf_size +
+				       VS_UP_ALIGN(tile_cnt * _vs_get_pvric_lossy_bytes(format), stride);
 
 		/* Get bo_height with header buffer and addr alignment */
-		bo_height = aligned_area / stride;
-		bo_param->height = bo_height;
+		bo_param->height = aligned_area / stride;
 		bo_param->header_size = tile_cnt;
+	} else if (fourcc_mod_vs_is_decnano(modifier) || fourcc_mod_vs_is_etc2(modifier)) {
+		/* buffer size calculation for DECNano/ETC2 fixed rate blocks */
+		tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
+		block = &vs_block_tab[_vs_get_mod_family(modifier)][tile_mode];
+		block_bytes = _vs_get_block_bytes(_vs_get_mod_family(modifier), tile_mode, format,
+						  bo_param->bpp);
+		if (!block_bytes || !stride)
+			goto out;
+
+		tile_cnt = ((bo_param->width + block->width - 1) / block->width) *
+			   ((bo_param->height + block->height - 1) / block->height);
+		aligned_area = tile_cnt * block_bytes;
+
+		/* Get bo_height of the compressed data, no header nor tile status */
+		bo_param->height = (aligned_area + stride - 1) / stride;
+		bo_param->header_size = 0;
+		bo_param->ts_buf_size = 0;
 	}
+
+out:
+	bo_param->pitch = stride;
+	bo_param->size = stride * bo_param->height;
 }
 
-int drm_vs_bo_config(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
-		     drm_vs_bo_param bo_param[4])
+/* whether DRM_IOCTL_MODE_CREATE_DUMB can allocate the plane, see drm_mode_create_dumb() */
+static bool _vs_bo_fits_dumb(const drm_vs_bo_param64 *bo_param)
 {
-	uint32_t num_planes;
-	uint64_t modifiers[4] = { 0 };
+	uint64_t cpp = (bo_param->bpp + 7) / 8;
+	uint64_t stride = cpp * bo_param->width;
+
+	if (stride > UINT32_MAX || bo_param->height > UINT32_MAX)
+		return false;
+	if (stride && bo_param->height > UINT32_MAX / stride)
+		return false;
+
+	return bo_param->header_size <= UINT32_MAX && bo_param->ts_buf_size <= UINT32_MAX;
+}
+
+static int _vs_calibrate_bo_size32(drm_vs_bo_param *bo_param, uint64_t modifier, uint32_t format)
+{
+	drm_vs_bo_param64 param = {
+		.width = bo_param->width,
+		.height = bo_param->height,
+		.bpp = bo_param->bpp,
+		.header_size = bo_param->header_size,
+		.ts_buf_size = bo_param->ts_buf_size,
+	};
+
+	_vs_calibrate_bo_size64(&param, modifier, format);
+
+	bo_param->height = param.height;
+	bo_param->header_size = param.header_size;
+	bo_param->ts_buf_size = param.ts_buf_size;
+
+	return _vs_bo_fits_dumb(&param) ? 0 : -EOVERFLOW;
+}
+
+void drm_vs_calibrate_bo_size(drm_vs_bo_param *bo_param, uint64_t modifier, uint32_t format)
+{
+	_vs_calibrate_bo_size32(bo_param, modifier, format);
+}
+
+/*
+ * Tile status of a DEC400 plane calibrated by drm_vs_calibrate_bo_size:
+ * rows added to the height for it, bytes used of them, and tiles covered.
+ */
+static int _vs_get_dec_ts_extent(const drm_vs_bo_param *bo_param, uint64_t modifier,
+				 uint64_t *ts_rows, uint64_t *ts_size, uint64_t *tiles)
+{
+	uint8_t tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
+	uint64_t stride, fc_size = 0, aligned_area;
+	uint16_t tile_size;
+
+	if (!bo_param || !fourcc_mod_vs_is_compressed(modifier))
+		return -EINVAL;
+
+	stride = (uint64_t)bo_param->width * bo_param->bpp / 8;
+	tile_size = vs_get_dec_tile_size(tile_mode, bo_param->bpp);
+	if (!stride || !tile_size)
+		return -EINVAL;
+
+	if (dec_mod_is_fc(modifier))
+		fc_size = VS_DEC_FC_SIZE(dec_mod_get_fc_size(modifier));
+
+	/* rows of the tile status, fast clear area included */
+	*ts_rows = VS_ALIGN_NP2((uint64_t)bo_param->ts_buf_size, stride) / stride;
+	if (bo_param->ts_buf_size < fc_size || *ts_rows > bo_param->height)
+		return -EINVAL;
+
+	aligned_area = VS_ALIGN_NP2(stride, (uint64_t)tile_size) * (bo_param->height - *ts_rows);
+	*ts_size = _vs_get_ts_buf_size(aligned_area, tile_size, tile_mode);
+	*tiles = aligned_area / tile_size;
+
+	return 0;
+}
+
+int drm_vs_clear_tile_status(void *ts, const drm_vs_bo_param *bo_param, uint64_t modifier,
+			     uint64_t clear_color)
+{
+	uint8_t tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
+	uint64_t ts_rows, ts_size, tiles, fc_size, i;
+	uint32_t cpp;
+	uint8_t *fc;
+
+	if (!ts || _vs_get_dec_ts_extent(bo_param, modifier, &ts_rows, &ts_size, &tiles))
+		return -EINVAL;
+
+	memset(ts, _vs_dec_ts_is_8bit(tile_mode) ? VS_DEC_TS_CLEAR_8BIT : VS_DEC_TS_CLEAR_4BIT,
+	       ts_size);
+
+	/* fast clear color, pixel by pixel, after the row aligned tile status */
+	fc_size = dec_mod_is_fc(modifier) ? VS_DEC_FC_SIZE(dec_mod_get_fc_size(modifier)) : 0;
+	fc = (uint8_t *)ts + bo_param->ts_buf_size - fc_size;
+	cpp = bo_param->bpp % 8 ? 4 : bo_param->bpp / 8;
+	for (i = 0; i < fc_size; i++)
+		fc[i] = clear_color >> (i % cpp * 8);
+
+	return 0;
+}
+
+/*
+ * Count the codes of @size tile status/header bytes, one per byte or two
+ * per byte (@nibbles, low nibble first): uncompressed (0) and clear (1)
+ * codes, and the sum of all codes.
+ */
+static void _vs_count_ts_codes(const uint8_t *ts, uint64_t size, bool nibbles, uint64_t *zero,
+			       uint64_t *one, uint64_t *sum)
+{
+	uint64_t k = 0;
+	uint8_t code;
+	int n;
+
+#if defined(__SSE2__) && defined(__x86_64__)
+	const __m128i mask = _mm_set1_epi8(0x0f), ones = _mm_set1_epi8(1), nul = _mm_setzero_si128();
+	__m128i acc_zero = nul, acc_one = nul, acc_sum = nul, v[2];
+
+	/* psadbw against zero sums 8 bytes into each 64-bit lane */
+	for (; k + 16 <= size; k += 16) {
+		v[0] = _mm_loadu_si128((const __m128i *)(ts + k));
+		v[1] = nul;
+		if (nibbles) {
+			v[1] = _mm_and_si128(_mm_srli_epi16(v[0], 4), mask);
+			v[0] = _mm_and_si128(v[0], mask);
+		}
+		for (n = 0; n < (nibbles ? 2 : 1); n++) {
+			acc_sum = _mm_add_epi64(acc_sum, _mm_sad_epu8(v[n], nul));
+			acc_zero = _mm_add_epi64(
+				acc_zero,
+				_mm_sad_epu8(_mm_and_si128(_mm_cmpeq_epi8(v[n], nul), ones), nul));
+			acc_one = _mm_add_epi64(
+				acc_one,
+				_mm_sad_epu8(_mm_and_si128(_mm_cmpeq_epi8(v[n], ones), ones), nul));
+		}
+	}
+	*zero += (uint64_t)_mm_cvtsi128_si64(acc_zero) +
+		 (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc_zero, acc_zero));
+	*one += (uint64_t)_mm_cvtsi128_si64(acc_one) +
+		(uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc_one, acc_one));
+	*sum += (uint64_t)_mm_cvtsi128_si64(acc_sum) +
+		(uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc_sum, acc_sum));
+#elif defined(__aarch64__)
+	const uint8x16_t mask = vdupq_n_u8(0x0f), ones = vdupq_n_u8(1);
+	uint64x2_t acc_zero = vdupq_n_u64(0), acc_one = acc_zero, acc_sum = acc_zero;
+	uint16x8_t part_zero, part_one, part_sum;
+	uint8x16_t v[2];
+	uint64_t end;
+
+	/* 16 bit lanes gain at most 2 * 255 per 16 bytes, fold them every 128 */
+	while (k + 16 <= size) {
+		part_zero = vdupq_n_u16(0);
+		part_one = part_zero;
+		part_sum = part_zero;
+		for (end = k + 128 * 16; k + 16 <= size && k < end; k += 16) {
+			v[0] = vld1q_u8(ts + k);
+			v[1] = vdupq_n_u8(0);
+			if (nibbles) {
+				v[1] = vshrq_n_u8(v[0], 4);
+				v[0] = vandq_u8(v[0], mask);
+			}
+			for (n = 0; n < (nibbles ? 2 : 1); n++) {
+				part_sum = vpadalq_u8(part_sum, v[n]);
+				part_zero = vpadalq_u8(part_zero, vandq_u8(vceqzq_u8(v[n]), ones));
+				part_one = vpadalq_u8(part_one, vandq_u8(vceqq_u8(v[n], ones), ones));
+			}
+		}
+		acc_sum = vpadalq_u32(acc_sum, vpaddlq_u16(part_sum));
+		acc_zero = vpadalq_u32(acc_zero, vpaddlq_u16(part_zero));
+		acc_one = vpadalq_u32(acc_one, vpaddlq_u16(part_one));
+	}
+	*zero += vaddvq_u64(acc_zero);
+	*one += vaddvq_u64(acc_one);
+	*sum += vaddvq_u64(acc_sum);
+#endif
+
+	for (; k < size; k++) {
+		for (n = 0; n < (nibbles ? 2 : 1); n++) {
+			code = nibbles ? (ts[k] >> (n * 4)) & 0x0f : ts[k];
+			*zero += code == VS_TS_CODE_UNCOMPRESSED;
+			*one += code == VS_TS_CODE_CLEAR;
+			*sum += code;
+		}
+	}
+}
+
+int drm_vs_analyze_compression(const void *ts, const drm_vs_bo_param *bo_param,
+			       uint64_t modifier, uint32_t format,
+			       drm_vs_compression_stats *stats)
+{
+	uint64_t ts_rows, ts_size, tiles, zero = 0, one = 0, sum = 0, lossy_size = 0;
+	uint32_t tile_size, code_max;
+	const uint8_t *codes = ts;
+	uint8_t code;
+	bool nibbles;
+
+	if (!ts || !stats)
+		return -EINVAL;
+
+	memset(stats, 0, sizeof(*stats));
+
+	if (fourcc_mod_vs_is_compressed(modifier)) {
+		if (_vs_get_dec_ts_extent(bo_param, modifier, &ts_rows, &ts_size, &tiles))
+			return -EINVAL;
+
+		tile_size = vs_get_dec_tile_size(fourcc_mod_vs_get_tile_mode(modifier),
+						 bo_param->bpp);
+		nibbles = !_vs_dec_ts_is_8bit(fourcc_mod_vs_get_tile_mode(modifier));
+	} else if (fourcc_mod_vs_is_pvric(modifier)) {
+		if (!bo_param || !bo_param->header_size)
+			return -EINVAL;
+
+		/* one header byte per 256 byte tile */
+		ts_size = bo_param->header_size;
+		tiles = bo_param->header_size;
+		tile_size = 256;
+		nibbles = false;
+		if (modifier & DRM_FORMAT_MOD_VS_DEC_LOSSY)
+			lossy_size = _vs_get_pvric_lossy_bytes(format);
+	} else {
+		return -EINVAL;
+	}
+
+	code_max = nibbles ? 16 : 256;
+
+	tiles = VS_MIN(tiles, ts_size * (nibbles ? 2 : 1));
+	_vs_count_ts_codes(codes, nibbles ? tiles / 2 : tiles, nibbles, &zero, &one, &sum);
+
+	/* a last odd tile of 4-bit tile status sits in a low nibble alone */
+	if (nibbles && tiles % 2) {
+		code = codes[tiles / 2] & 0x0f;
+		zero += code == VS_TS_CODE_UNCOMPRESSED;
+		one += code == VS_TS_CODE_CLEAR;
+		sum += code;
+	}
+
+	stats->tiles = tiles;
+	stats->uncompressed_tiles = zero;
+	stats->clear_tiles = one;
+	stats->compressed_tiles = tiles - zero - one;
+	stats->raw_bytes = tiles * tile_size;
+
+	/* compressed tiles fetch @code / code_max of the tile, clear tiles nothing */
+	if (lossy_size)
+		stats->fetch_bytes = (tiles - one) * lossy_size;
+	else
+		stats->fetch_bytes = zero * tile_size + (sum - one) * tile_size / code_max;
+	stats->fetch_bytes += ts_size;
+
+	if (stats->raw_bytes)
+		stats->ratio = stats->fetch_bytes * 100 / stats->raw_bytes;
+
+	return 0;
+}
+
+static int _vs_bo_config(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			 drm_vs_bo_param bo_param[4], uint64_t modifiers[4])
+{
+	uint32_t num_planes, i;
 	int ret;
 
 	memset(bo_param, 0, sizeof(drm_vs_bo_param) * 4);
+	memset(modifiers, 0, sizeof(uint64_t) * 4);
 
 	ret = _vs_get_format_info(width, height, format, mod, &num_planes, bo_param);
 	if (ret)
@@ -1880,11 +1930,1773 @@ int drm_vs_bo_config(uint32_t width, uint32_t height, uint32_t format, uint64_t
 	if (ret)
 		return ret;
 
-	_vs_cal_bo_size(bo_param, modifiers, format, num_planes);
+	for (i = 0; i < num_planes; i++) {
+		ret = _vs_calibrate_bo_size32(&bo_param[i], modifiers[i], format);
+		if (ret) {
+			fprintf(stderr, "bo size of plane %u overflows for %ux%u\n", i, width,
+				height);
+			return ret;
+		}
+	}
 
 	return 0;
 }
 
+int drm_vs_bo_config64(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+		       drm_vs_bo_param64 bo_param[4], uint64_t modifiers[4])
+{
+	drm_vs_bo_param planes[4] = { 0 };
+	uint32_t num_planes, i;
+	int ret;
+
+	memset(bo_param, 0, sizeof(drm_vs_bo_param64) * 4);
+	memset(modifiers, 0, sizeof(uint64_t) * 4);
+
+	if (width > VS_MAX_SURFACE_SIZE || height > VS_MAX_SURFACE_SIZE)
+		return -EINVAL;
+
+	ret = _vs_get_format_info(width, height, format, mod, &num_planes, planes);
+	if (ret)
+		return ret;
+	ret = vs_mod_config(format, mod, num_planes, modifiers);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < num_planes; i++) {
+		bo_param[i].width = planes[i].width;
+		bo_param[i].height = planes[i].height;
+		bo_param[i].bpp = planes[i].bpp;
+
+		_vs_calibrate_bo_size64(&bo_param[i], modifiers[i], format);
+		if (!_vs_bo_fits_dumb(&bo_param[i]))
+			ret = -EOVERFLOW;
+	}
+
+	return ret;
+}
+
+/*
+ * drm_vs_bo_config result cache.
+ *
+ * Fixed size direct mapped table, every slot is guarded by a sequence
+ * counter: writers make it odd while they update the slot, readers copy
+ * the slot and take it as a miss if the counter moved meanwhile. Lookups
+ * and inserts never block, a lost race is just a miss or a skipped insert;
+ * drm_vs_bo_cache_reset waits for the inserts in flight.
+ */
+#define VS_BO_CACHE_SLOTS 512
+#define VS_BO_CACHE_SHARDS 16
+#define VS_BO_CACHE_PARAM_WORDS 5
+
+enum {
+	VS_BO_CACHE_KEY_WIDTH,
+	VS_BO_CACHE_KEY_HEIGHT,
+	VS_BO_CACHE_KEY_FORMAT,
+	VS_BO_CACHE_KEY_MOD_LO,
+	VS_BO_CACHE_KEY_MOD_HI,
+	VS_BO_CACHE_KEY_WORDS,
+	VS_BO_CACHE_PARAM = VS_BO_CACHE_KEY_WORDS,
+	VS_BO_CACHE_MODS = VS_BO_CACHE_PARAM + 4 * VS_BO_CACHE_PARAM_WORDS,
+	/* nonzero once the slot holds a result, cleared by drm_vs_bo_cache_reset */
+	VS_BO_CACHE_VALID = VS_BO_CACHE_MODS + 4 * 2,
+	VS_BO_CACHE_WORDS,
+};
+
+typedef struct _vs_bo_cache_slot {
+	/* 0: empty, odd: being written, only ever grows so readers never see it reused */
+	_Atomic uint32_t seq;
+	_Atomic uint32_t data[VS_BO_CACHE_WORDS];
+} vs_bo_cache_slot;
+
+/* counters are sharded by slot to keep readers off a single cache line */
+typedef struct _vs_bo_cache_counter {
+	_Atomic uint64_t hits;
+	_Atomic uint64_t misses;
+} __attribute__((aligned(64))) vs_bo_cache_counter;
+
+static _Atomic bool vs_bo_cache_enabled;
+static vs_bo_cache_slot vs_bo_cache[VS_BO_CACHE_SLOTS];
+static vs_bo_cache_counter vs_bo_cache_counters[VS_BO_CACHE_SHARDS];
+
+static inline uint32_t _vs_bo_cache_hash(const uint32_t key[VS_BO_CACHE_KEY_WORDS])
+{
+	uint64_t hash = 0;
+	uint32_t i;
+
+	for (i = 0; i < VS_BO_CACHE_KEY_WORDS; i++)
+		hash = (hash ^ key[i]) * 0x9E3779B97F4A7C15ull;
+
+	return (uint32_t)(hash >> 32) & (VS_BO_CACHE_SLOTS - 1);
+}
+
+static bool _vs_bo_cache_lookup(const uint32_t key[VS_BO_CACHE_KEY_WORDS], uint32_t index,
+				drm_vs_bo_param bo_param[4], uint64_t modifiers[4])
+{
+	vs_bo_cache_slot *slot = &vs_bo_cache[index];
+	uint32_t data[VS_BO_CACHE_WORDS];
+	uint32_t seq, i;
+	const uint32_t *param;
+
+	seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+	if (!seq || (seq & 1))
+		return false;
+
+	for (i = 0; i < VS_BO_CACHE_WORDS; i++)
+		data[i] = atomic_load_explicit(&slot->data[i], memory_order_relaxed);
+
+	atomic_thread_fence(memory_order_acquire);
+	if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq)
+		return false;
+
+	if (!data[VS_BO_CACHE_VALID] ||
+	    memcmp(data, key, sizeof(uint32_t) * VS_BO_CACHE_KEY_WORDS))
+		return false;
+
+	for (i = 0; i < 4; i++) {
+		param = &data[VS_BO_CACHE_PARAM + i * VS_BO_CACHE_PARAM_WORDS];
+		memset(&bo_param[i], 0, sizeof(drm_vs_bo_param));
+		bo_param[i].width = param[0];
+		bo_param[i].height = param[1];
+		bo_param[i].bpp = (uint8_t)param[2];
+		bo_param[i].header_size = param[3];
+		bo_param[i].ts_buf_size = param[4];
+
+		modifiers[i] = (uint64_t)data[VS_BO_CACHE_MODS + i * 2] |
+			       (uint64_t)data[VS_BO_CACHE_MODS + i * 2 + 1] << 32;
+	}
+
+	return true;
+}
+
+static void _vs_bo_cache_insert(const uint32_t key[VS_BO_CACHE_KEY_WORDS], uint32_t index,
+				const drm_vs_bo_param bo_param[4], const uint64_t modifiers[4])
+{
+	vs_bo_cache_slot *slot = &vs_bo_cache[index];
+	uint32_t data[VS_BO_CACHE_WORDS];
+	uint32_t seq, i;
+	uint32_t *param;
+
+	memcpy(data, key, sizeof(uint32_t) * VS_BO_CACHE_KEY_WORDS);
+	for (i = 0; i < 4; i++) {
+		param = &data[VS_BO_CACHE_PARAM + i * VS_BO_CACHE_PARAM_WORDS];
+		param[0] = bo_param[i].width;
+		param[1] = bo_param[i].height;
+		param[2] = bo_param[i].bpp;
+		param[3] = bo_param[i].header_size;
+		param[4] = bo_param[i].ts_buf_size;
+
+		data[VS_BO_CACHE_MODS + i * 2] = (uint32_t)modifiers[i];
+		data[VS_BO_CACHE_MODS + i * 2 + 1] = (uint32_t)(modifiers[i] >> 32);
+	}
+	data[VS_BO_CACHE_VALID] = 1;
+
+	/* skip the insert if another writer owns the slot */
+	seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+	if ((seq & 1) || !atomic_compare_exchange_strong_explicit(&slot->seq, &seq, seq + 1,
+								  memory_order_acquire,
+								  memory_order_relaxed))
+		return;
+	atomic_thread_fence(memory_order_release);
+
+	for (i = 0; i < VS_BO_CACHE_WORDS; i++)
+		atomic_store_explicit(&slot->data[i], data[i], memory_order_relaxed);
+
+	atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+void drm_vs_bo_cache_enable(bool enable)
+{
+	atomic_store_explicit(&vs_bo_cache_enabled, enable, memory_order_relaxed);
+}
+
+void drm_vs_bo_cache_reset(void)
+{
+	uint32_t i, seq;
+
+	for (i = 0; i < VS_BO_CACHE_SLOTS; i++) {
+		/* spin while an insert owns the slot, it only copies the slot words */
+		do {
+			seq = atomic_load_explicit(&vs_bo_cache[i].seq, memory_order_relaxed) & ~1u;
+		} while (!atomic_compare_exchange_weak_explicit(&vs_bo_cache[i].seq, &seq, seq + 1,
+								 memory_order_acquire,
+								 memory_order_relaxed));
+		/* the slot misses until the next insert */
+		atomic_store_explicit(&vs_bo_cache[i].data[VS_BO_CACHE_VALID], 0,
+				      memory_order_relaxed);
+		atomic_store_explicit(&vs_bo_cache[i].seq, seq + 2, memory_order_release);
+	}
+
+	for (i = 0; i < VS_BO_CACHE_SHARDS; i++) {
+		atomic_store_explicit(&vs_bo_cache_counters[i].hits, 0, memory_order_relaxed);
+		atomic_store_explicit(&vs_bo_cache_counters[i].misses, 0, memory_order_relaxed);
+	}
+}
+
+void drm_vs_bo_cache_get_stats(drm_vs_bo_cache_stats *stats)
+{
+	uint32_t i;
+
+	stats->hits = 0;
+	stats->misses = 0;
+	for (i = 0; i < VS_BO_CACHE_SHARDS; i++) {
+		stats->hits += atomic_load_explicit(&vs_bo_cache_counters[i].hits,
+						    memory_order_relaxed);
+		stats->misses += atomic_load_explicit(&vs_bo_cache_counters[i].misses,
+						      memory_order_relaxed);
+	}
+}
+
+int drm_vs_bo_config_ext(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			 drm_vs_bo_param bo_param[4], uint64_t modifiers[4])
+{
+	uint32_t key[VS_BO_CACHE_KEY_WORDS] = { width, height, format, (uint32_t)mod,
+						(uint32_t)(mod >> 32) };
+	vs_bo_cache_counter *counter;
+	uint32_t index;
+	int ret;
+
+	if (!atomic_load_explicit(&vs_bo_cache_enabled, memory_order_relaxed))
+		return _vs_bo_config(width, height, format, mod, bo_param, modifiers);
+
+	index = _vs_bo_cache_hash(key);
+	counter = &vs_bo_cache_counters[index % VS_BO_CACHE_SHARDS];
+
+	if (_vs_bo_cache_lookup(key, index, bo_param, modifiers)) {
+		atomic_fetch_add_explicit(&counter->hits, 1, memory_order_relaxed);
+		return 0;
+	}
+	atomic_fetch_add_explicit(&counter->misses, 1, memory_order_relaxed);
+
+	ret = _vs_bo_config(width, height, format, mod, bo_param, modifiers);
+	if (!ret)
+		_vs_bo_cache_insert(key, index, bo_param, modifiers);
+
+	return ret;
+}
+
+int drm_vs_bo_config(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+		     drm_vs_bo_param bo_param[4])
+{
+	uint64_t modifiers[4];
+
+	return drm_vs_bo_config_ext(width, height, format, mod, bo_param, modifiers);
+}
+
+/*
+ * Batched align + bo_config.
+ *
+ * Requests are handled in chunks, inside a chunk they are sorted by
+ * (format, mod) so the format lookup, modifier decoding and vs_mod_config
+ * run once per group. Sizes of a group are gathered into plain arrays and
+ * aligned/divided four at a time.
+ */
+#define VS_BO_BATCH_CHUNK 64
+
+typedef struct _vs_bo_batch_key {
+	uint32_t format;
+	uint32_t index;
+	uint64_t mod;
+} vs_bo_batch_key;
+
+static int _vs_bo_batch_key_cmp(const void *a, const void *b)
+{
+	const vs_bo_batch_key *ka = a, *kb = b;
+
+	if (ka->format != kb->format)
+		return ka->format < kb->format ? -1 : 1;
+	if (ka->mod != kb->mod)
+		return ka->mod < kb->mod ? -1 : 1;
+
+	return ka->index < kb->index ? -1 : (ka->index > kb->index);
+}
+
+/* four lanes, lowered to SSE2/NEON or to scalar code by the compiler */
+typedef uint32_t vs_u32x4 __attribute__((vector_size(16)));
+
+static void _vs_align_batch(uint32_t *width, uint32_t *height, uint32_t count,
+			    const vs_mod_desc *desc)
+{
+	uint32_t w_mask = desc->align_w_mask, h_mask = desc->align_h_mask;
+	vs_u32x4 vw, vh;
+	uint32_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		memcpy(&vw, &width[i], sizeof(vw));
+		memcpy(&vh, &height[i], sizeof(vh));
+		vw = (vw + w_mask) & ~w_mask;
+		vh = (vh + h_mask) & ~h_mask;
+		memcpy(&width[i], &vw, sizeof(vw));
+		memcpy(&height[i], &vh, sizeof(vh));
+	}
+
+	for (; i < count; i++) {
+		width[i] = (width[i] + w_mask) & ~w_mask;
+		height[i] = (height[i] + h_mask) & ~h_mask;
+	}
+}
+
+static void _vs_div_batch(uint32_t *dst, const uint32_t *src, uint32_t count, uint32_t div)
+{
+	vs_u32x4 v;
+	uint32_t i = 0;
+
+	/* 2 is the common chroma divisor, the custom 10 bit layouts use 3 and 6 */
+	if (div != 2) {
+		for (; i < count; i++)
+			dst[i] = src[i] / div;
+		return;
+	}
+
+	for (; i + 4 <= count; i += 4) {
+		memcpy(&v, &src[i], sizeof(v));
+		v >>= 1;
+		memcpy(&dst[i], &v, sizeof(v));
+	}
+
+	for (; i < count; i++)
+		dst[i] = src[i] >> 1;
+}
+
+static int _vs_bo_config_group(const vs_bo_batch_key *keys, uint32_t count, const uint32_t *width,
+			       const uint32_t *height, drm_vs_bo_result *res)
+{
+	const vs_format_desc *fmt = _vs_find_format(keys[0].format);
+	const vs_layout_desc *layout = &fmt->layout[_vs_get_layout_variant(keys[0].mod)];
+	uint32_t plane_w[VS_BO_BATCH_CHUNK], plane_h[VS_BO_BATCH_CHUNK];
+	uint64_t modifiers[4] = { 0 };
+	drm_vs_bo_param *param;
+	uint32_t i, p;
+	int ret = 0;
+
+	if (!layout->num_planes) {
+		fprintf(stderr, "unsupported format %u for mod: %lx \n", keys[0].format,
+			keys[0].mod);
+		return -EINVAL;
+	}
+	if (vs_mod_config(keys[0].format, keys[0].mod, layout->num_planes, modifiers))
+		return -EINVAL;
+
+	for (p = 0; p < layout->num_planes; p++) {
+		_vs_div_batch(plane_w, width, count, layout->plane[p].width_div);
+		_vs_div_batch(plane_h, height, count, layout->plane[p].height_div);
+
+		for (i = 0; i < count; i++) {
+			param = &res[keys[i].index].bo_param[p];
+			param->width = plane_w[i];
+			param->height = plane_h[i];
+			param->bpp = layout->plane[p].bpp;
+			if (_vs_calibrate_bo_size32(param, modifiers[p], keys[0].format))
+				res[keys[i].index].ret = ret = -EOVERFLOW;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		res[keys[i].index].num_planes = layout->num_planes;
+		memcpy(res[keys[i].index].modifiers, modifiers, sizeof(modifiers));
+	}
+
+	/* only the overflowed requests fail */
+	return ret;
+}
+
+static int _vs_bo_batch(const drm_vs_bo_request *req, drm_vs_bo_result *res, uint32_t count,
+			bool config)
+{
+	vs_bo_batch_key keys[VS_BO_BATCH_CHUNK];
+	uint32_t width[VS_BO_BATCH_CHUNK], height[VS_BO_BATCH_CHUNK];
+	uint32_t base, n, start, end, i;
+	const vs_mod_desc *desc;
+	int ret = 0, group_ret;
+
+	if (!count)
+		return 0;
+	if (!req || !res)
+		return -EINVAL;
+
+	memset(res, 0, sizeof(drm_vs_bo_result) * count);
+
+	for (base = 0; base < count; base += n) {
+		n = VS_MIN(count - base, VS_BO_BATCH_CHUNK);
+
+		for (i = 0; i < n; i++) {
+			keys[i].format = req[base + i].format;
+			keys[i].mod = req[base + i].mod;
+			keys[i].index = base + i;
+		}
+		qsort(keys, n, sizeof(keys[0]), _vs_bo_batch_key_cmp);
+
+		for (start = 0; start < n; start = end) {
+			for (end = start + 1; end < n; end++) {
+				if (keys[end].format != keys[start].format ||
+				    keys[end].mod != keys[start].mod)
+					break;
+			}
+
+			for (i = start; i < end; i++) {
+				width[i - start] = req[keys[i].index].width;
+				height[i - start] = req[keys[i].index].height;
+			}
+
+			desc = _vs_get_mod_desc(_vs_find_format(keys[start].format),
+						_vs_get_mod_family(keys[start].mod),
+						fourcc_mod_vs_get_tile_mode(keys[start].mod));
+			_vs_align_batch(width, height, end - start, desc);
+
+			for (i = start; i < end; i++) {
+				res[keys[i].index].width = width[i - start];
+				res[keys[i].index].height = height[i - start];
+			}
+
+			if (!config)
+				continue;
+
+			group_ret = _vs_bo_config_group(&keys[start], end - start, width, height,
+							res);
+			if (group_ret == -EOVERFLOW) {
+				ret = group_ret;
+			} else if (group_ret) {
+				for (i = start; i < end; i++)
+					res[keys[i].index].ret = group_ret;
+				ret = group_ret;
+			}
+		}
+	}
+
+	return ret;
+}
+
+int drm_vs_get_align_size_batch(const drm_vs_bo_request *req, drm_vs_bo_result *res,
+				uint32_t count)
+{
+	return _vs_bo_batch(req, res, count, false);
+}
+
+int drm_vs_bo_config_batch(const drm_vs_bo_request *req, drm_vs_bo_result *res, uint32_t count)
+{
+	return _vs_bo_batch(req, res, count, true);
+}
+
+/* base address alignment of a plane inside a single buffer */
+#define VS_PLANE_ALIGN 64
+/* compression unit / PVRIC data base address alignment */
+#define VS_PLANE_COMPRESSED_ALIGN 256
+
+static uint32_t _vs_get_plane_align(uint64_t modifier)
+{
+	switch (_vs_get_mod_family(modifier)) {
+	case VS_MOD_FAMILY_DEC400:
+	case VS_MOD_FAMILY_DEC400A:
+	case VS_MOD_FAMILY_PVRIC:
+		return VS_PLANE_COMPRESSED_ALIGN;
+	default:
+		return VS_PLANE_ALIGN;
+	}
+}
+
+int drm_vs_get_bo_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			 drm_vs_bo_layout *layout)
+{
+	drm_vs_bo_param64 bo_param[4];
+	drm_vs_format_desc desc;
+	uint64_t offset = 0, data_height;
+	uint32_t i, align;
+	int ret, fit;
+
+	if (!layout)
+		return -EINVAL;
+
+	memset(layout, 0, sizeof(*layout));
+
+	ret = drm_vs_get_format_desc(format, mod, &desc);
+	if (ret)
+		return ret;
+	/* a plane too large for the dumb buffer ABI is still laid out */
+	fit = drm_vs_bo_config64(width, height, format, mod, bo_param, layout->modifiers);
+	if (fit && fit != -EOVERFLOW)
+		return fit;
+
+	layout->num_planes = desc.num_planes;
+	for (i = 0; i < desc.num_planes; i++) {
+		align = _vs_get_plane_align(layout->modifiers[i]);
+		data_height = height / desc.vsub[i];
+
+		offset = VS_UP_ALIGN(offset, (uint64_t)align);
+		layout->pitches[i] = bo_param[i].pitch;
+		layout->plane_size[i] = bo_param[i].size;
+
+		switch (_vs_get_mod_family(layout->modifiers[i])) {
+		case VS_MOD_FAMILY_DEC400:
+		case VS_MOD_FAMILY_DEC400A:
+			/* tile status follows the plane data */
+			layout->offsets[i] = offset;
+			layout->ts_offsets[i] = offset + bo_param[i].pitch * data_height;
+			layout->ts_size[i] = bo_param[i].ts_buf_size;
+			break;
+		case VS_MOD_FAMILY_PVRIC:
+			/* header comes first, data starts at the next aligned address */
+			layout->ts_offsets[i] = offset;
+			layout->ts_size[i] = bo_param[i].header_size;
+			layout->offsets[i] = offset + VS_UP_ALIGN(bo_param[i].header_size,
+							       (uint64_t)VS_PLANE_COMPRESSED_ALIGN);
+			break;
+		default:
+			layout->offsets[i] = offset;
+			break;
+		}
+
+		/* the plane covers its tile status, fast clear area included */
+		if (layout->ts_offsets[i] + layout->ts_size[i] > offset + layout->plane_size[i])
+			layout->plane_size[i] = layout->ts_offsets[i] + layout->ts_size[i] - offset;
+
+		offset += layout->plane_size[i];
+	}
+
+	layout->size = offset;
+
+	/* one DRM_IOCTL_MODE_CREATE_DUMB of 8bpp rows, as wide as plane 0 */
+	layout->dumb.bpp = 8;
+	layout->dumb.width = layout->pitches[0];
+	if (layout->pitches[0]) {
+		data_height = (layout->size + layout->pitches[0] - 1) / layout->pitches[0];
+		if (data_height > UINT32_MAX / layout->pitches[0])
+			fit = -EOVERFLOW;
+		else
+			layout->dumb.height = data_height;
+	}
+
+	return fit;
+}
+
+/* pad a linear pitch to a divisor or multiple of @page_size if it costs at most 1/16 of it */
+static uint32_t _vs_get_paged_pitch(uint32_t pitch, uint64_t page_size)
+{
+	uint64_t padded;
+
+	if (!pitch)
+		return pitch;
+
+	if (pitch < page_size) {
+		padded = 1;
+		while (padded < pitch)
+			padded <<= 1;
+	} else {
+		padded = VS_UP_ALIGN((uint64_t)pitch, page_size);
+	}
+
+	if (padded - pitch > pitch / 16 || padded > UINT32_MAX)
+		return pitch;
+
+	return padded;
+}
+
+int drm_vs_get_bo_layout_paged(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			       uint64_t page_size, drm_vs_bo_layout *layout,
+			       drm_vs_page_cost *cost)
+{
+	drm_vs_bo_layout base;
+	uint64_t offset = 0, rows, data_size;
+	uint32_t i;
+	int ret;
+
+	if (!layout ||
+	    (page_size != VS_PAGE_SIZE_4K && page_size != VS_PAGE_SIZE_64K &&
+	     page_size != VS_PAGE_SIZE_2M))
+		return -EINVAL;
+
+	ret = drm_vs_get_bo_layout(width, height, format, mod, &base);
+	if (ret)
+		return ret;
+
+	*layout = base;
+	for (i = 0; i < base.num_planes; i++) {
+		offset = VS_UP_ALIGN(offset, page_size);
+		rows = base.pitches[i] ? base.plane_size[i] / base.pitches[i] : 0;
+
+		switch (_vs_get_mod_family(base.modifiers[i])) {
+		case VS_MOD_FAMILY_DEC400:
+		case VS_MOD_FAMILY_DEC400A:
+			/* the tile status address is derived from the data, keep it behind */
+			data_size = base.ts_offsets[i] - base.offsets[i];
+			layout->offsets[i] = offset;
+			layout->ts_offsets[i] = offset + data_size;
+			break;
+		case VS_MOD_FAMILY_PVRIC:
+			/* the data address is derived from the header, move both */
+			layout->ts_offsets[i] = offset;
+			layout->offsets[i] = offset + base.offsets[i] - base.ts_offsets[i];
+			break;
+		default:
+			if (fourcc_mod_vs_is_normal(base.modifiers[i]) &&
+			    (base.modifiers[i] & DRM_FORMAT_MOD_VS_NORM_MODE_MASK) ==
+				    DRM_FORMAT_MOD_VS_LINEAR)
+				layout->pitches[i] = _vs_get_paged_pitch(base.pitches[i], page_size);
+			layout->offsets[i] = offset;
+			layout->plane_size[i] = rows * layout->pitches[i];
+			break;
+		}
+
+		offset += layout->plane_size[i];
+	}
+
+	layout->size = VS_UP_ALIGN(offset, page_size);
+	layout->dumb.width = layout->pitches[0];
+	if (layout->pitches[0]) {
+		rows = (layout->size + layout->pitches[0] - 1) / layout->pitches[0];
+		if (rows > UINT32_MAX / layout->pitches[0])
+			ret = -EOVERFLOW;
+		else
+			layout->dumb.height = rows;
+	}
+
+	if (cost) {
+		cost->page_size = page_size;
+		cost->base_size = base.size;
+		cost->size = layout->size;
+		cost->base_tlb_entries = (base.size + VS_PAGE_SIZE_4K - 1) / VS_PAGE_SIZE_4K;
+		cost->tlb_entries = layout->size / page_size;
+	}
+
+	return ret;
+}
+
+static uint64_t _vs_gcd(uint64_t a, uint64_t b)
+{
+	uint64_t t;
+
+	while (b) {
+		t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+static uint64_t _vs_lcm(uint64_t a, uint64_t b)
+{
+	return a / _vs_gcd(a, b) * b;
+}
+
+/*
+ * Bytes of a tile row covered by one tile status byte of a DEC400 plane:
+ * 8-bit status per 256 bytes for the UNIT2X2 modes, 4-bit status per
+ * 256 bytes otherwise, per 128 bytes for 128 byte tiles.
+ */
+static uint32_t _vs_get_ts_byte_span(uint64_t modifier, uint8_t bpp)
+{
+	uint8_t tile_mode = fourcc_mod_vs_get_tile_mode(modifier);
+
+	if (_vs_dec_ts_is_8bit(tile_mode))
+		return 256;
+
+	return vs_get_dec_tile_size(tile_mode, bpp) == 128 ? 256 : 512;
+}
+
+int drm_vs_get_split_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			    uint32_t num_pipes, drm_vs_split_layout *split)
+{
+	drm_vs_tile_geometry geometry;
+	drm_vs_format_desc desc;
+	drm_vs_split_pipe *pipe;
+	uint64_t align = 1, byte_align[4], bits, col_bytes, x, ideal;
+	uint32_t i, k, tile_h[4], plane_x, sb_w;
+	int ret;
+
+	if (!split || !num_pipes || num_pipes > VS_MAX_SPLIT_PIPES)
+		return -EINVAL;
+
+	memset(split, 0, sizeof(*split));
+
+	ret = drm_vs_get_bo_layout(width, height, format, mod, &split->layout);
+	if (ret)
+		return ret;
+	if (drm_vs_get_format_desc(format, mod, &desc) ||
+	    drm_vs_get_tile_geometry(format, mod, &geometry))
+		return -EINVAL;
+
+	/* every plane: whole tiles, fetch aligned, whole tile status bytes */
+	for (i = 0; i < desc.num_planes; i++) {
+		if (!geometry.width[i] || !geometry.height[i])
+			return -EINVAL;
+
+		tile_h[i] = geometry.height[i];
+		byte_align[i] = _vs_get_plane_align(split->layout.modifiers[i]);
+		switch (_vs_get_mod_family(split->layout.modifiers[i])) {
+		case VS_MOD_FAMILY_DEC400:
+			byte_align[i] = _vs_lcm(byte_align[i],
+						_vs_get_ts_byte_span(split->layout.modifiers[i],
+								     desc.bpp[i]));
+			split->ts_pitches[i] = (uint64_t)split->layout.pitches[i] * tile_h[i] /
+					       _vs_get_ts_byte_span(split->layout.modifiers[i],
+								    desc.bpp[i]);
+			break;
+		case VS_MOD_FAMILY_DEC400A:
+			/* one 16 byte header per superblock */
+			_vs_get_dec400a_superblock(format, &sb_w, NULL);
+			split->ts_pitches[i] = (width / desc.hsub[i] + sb_w - 1) / sb_w *
+					       VS_DEC400A_HEADER_SIZE;
+			geometry.width[i] = _vs_lcm(geometry.width[i], sb_w);
+			break;
+		case VS_MOD_FAMILY_PVRIC:
+			/* one header byte per 256 bytes of data */
+			split->ts_pitches[i] = (uint64_t)split->layout.pitches[i] * tile_h[i] / 256;
+			break;
+		default:
+			break;
+		}
+
+		/* columns whose tile row bytes are a multiple of byte_align */
+		bits = (uint64_t)desc.bpp[i] * tile_h[i];
+		x = byte_align[i] * 8 / _vs_gcd(byte_align[i] * 8, bits);
+		align = _vs_lcm(align, _vs_lcm(x, geometry.width[i]) * desc.hsub[i]);
+	}
+	align = _vs_lcm(align, desc.align_width);
+
+	if (align > UINT32_MAX || align * num_pipes > width)
+		return -ERANGE;
+
+	split->num_pipes = num_pipes;
+	split->align = align;
+
+	for (k = 0; k < num_pipes; k++) {
+		pipe = &split->pipes[k];
+
+		/* nearest aligned column to an even split, every pipe non-empty */
+		ideal = (uint64_t)width * k / num_pipes;
+		x = (ideal + align / 2) / align * align;
+		if (k && x <= split->pipes[k - 1].x)
+			x = split->pipes[k - 1].x + align;
+		if (x + (num_pipes - k - 1) * align >= width && k)
+			return -ERANGE;
+
+		pipe->x = k ? x : 0;
+		if (k)
+			split->pipes[k - 1].width = pipe->x - split->pipes[k - 1].x;
+
+		for (i = 0; i < desc.num_planes; i++) {
+			plane_x = pipe->x / desc.hsub[i];
+			col_bytes = (uint64_t)plane_x * desc.bpp[i] / 8 * tile_h[i];
+			pipe->offsets[i] = split->layout.offsets[i] + col_bytes;
+
+			switch (_vs_get_mod_family(split->layout.modifiers[i])) {
+			case VS_MOD_FAMILY_DEC400:
+				pipe->ts_offsets[i] = split->layout.ts_offsets[i] +
+						      col_bytes /
+							      _vs_get_ts_byte_span(
+								      split->layout.modifiers[i],
+								      desc.bpp[i]);
+				break;
+			case VS_MOD_FAMILY_DEC400A:
+				_vs_get_dec400a_superblock(format, &sb_w, NULL);
+				pipe->ts_offsets[i] = split->layout.ts_offsets[i] +
+						      plane_x / sb_w * VS_DEC400A_HEADER_SIZE;
+				break;
+			case VS_MOD_FAMILY_PVRIC:
+				pipe->ts_offsets[i] = split->layout.ts_offsets[i] + col_bytes / 256;
+				/* lossy tiles are packed to a fixed 128 or 96 bytes */
+				if (split->layout.modifiers[i] & DRM_FORMAT_MOD_VS_DEC_LOSSY)
+					pipe->offsets[i] = split->layout.offsets[i] +
+							   col_bytes / 256 *
+								   _vs_get_pvric_lossy_bytes(format);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	split->pipes[num_pipes - 1].width = width - split->pipes[num_pipes - 1].x;
+
+	return 0;
+}
+
+/*
+ * Tile modes of @family that the helpers know how to lay out, and for
+ * DEC400 formats with chroma rules, the ones listed for @format.
+ */
+static bool _vs_tile_mode_usable(uint32_t format, vs_mod_family family, uint8_t tile_mode)
+{
+	bool listed;
+
+	switch (family) {
+	case VS_MOD_FAMILY_DEC400A:
+		return vs_tile_geometry[VS_MOD_FAMILY_NORMAL][tile_mode][0] != 0;
+	case VS_MOD_FAMILY_DECNANO:
+		return vs_block_tab[family][tile_mode].width != 0;
+	case VS_MOD_FAMILY_ETC2:
+		return vs_block_tab[family][tile_mode].width != 0 && _vs_get_etc2_block_bytes(format);
+	case VS_MOD_FAMILY_DEC400:
+		if (!_vs_find_chroma_rule(format, tile_mode, &listed) && listed)
+			return false;
+		return vs_tile_geometry[family][tile_mode][0] != 0 &&
+		       vs_get_dec_tile_size(tile_mode, 8) != 0;
+	default:
+		return vs_tile_geometry[family][tile_mode][0] != 0;
+	}
+}
+
+/*
+ * Lines the display fetches at once and contiguous bytes of one fetch of
+ * a plane of @extent pixels along the scan, @rotated for a scan down the
+ * buffer columns.
+ */
+static void _vs_get_fetch_cost(vs_mod_family family, uint8_t tile_mode, uint32_t tile_w,
+			       uint32_t tile_h, uint32_t tile_bytes, bool rotated, uint32_t extent,
+			       uint32_t *depth, uint64_t *burst)
+{
+	const vs_fetch_order *order = &vs_fetch_order_tab[family][tile_mode];
+	uint32_t along, tiles;
+	bool y_major = false;
+
+	if (order->tile_w) {
+		tile_bytes = tile_bytes / (tile_w * tile_h) * order->tile_w * order->tile_h;
+		tile_w = order->tile_w;
+		tile_h = order->tile_h;
+		y_major = order->y_major;
+	}
+
+	along = rotated ? tile_h : tile_w;
+	*depth = rotated ? tile_w : tile_h;
+
+	/* tiles are contiguous along their major direction only */
+	if (y_major != rotated)
+		tiles = 1;
+	else if (order->group)
+		tiles = order->group;
+	else
+		tiles = (extent + along - 1) / along;
+
+	*burst = (uint64_t)tile_bytes * tiles;
+}
+
+static void _vs_rate_rotated_layout(uint32_t format, uint32_t rotation,
+				    drm_vs_rotated_layout *rotated)
+{
+	drm_vs_tile_geometry geometry;
+	drm_vs_format_desc desc;
+	vs_mod_family family;
+	uint32_t i, depth, extent, bytes;
+	uint64_t burst, efficiency;
+	bool by_column = rotation == VS_ROTATION_90 || rotation == VS_ROTATION_270;
+
+	rotated->line_depth = 0;
+	rotated->burst_bytes = UINT32_MAX;
+	rotated->efficiency = 100;
+
+	drm_vs_get_format_desc(format, rotated->mod, &desc);
+	drm_vs_get_tile_geometry(format, rotated->mod, &geometry);
+
+	/* the worst plane limits the fetch */
+	for (i = 0; i < geometry.num_planes; i++) {
+		family = _vs_get_mod_family(rotated->layout.modifiers[i]);
+		extent = by_column ? rotated->height / desc.vsub[i] : rotated->width / desc.hsub[i];
+		/* at least one byte, e.g. for 1x1 tiles of 4 bpp planes */
+		bytes = geometry.bytes[i] ? geometry.bytes[i] : 1;
+
+		_vs_get_fetch_cost(family,
+				   rotated->layout.modifiers[i] & vs_mod_family_tile_mask[family],
+				   geometry.width[i], geometry.height[i], bytes, by_column, extent,
+				   &depth, &burst);
+
+		efficiency = burst >= VS_FETCH_BURST_SIZE ? 100 : burst * 100 / VS_FETCH_BURST_SIZE;
+		if (depth > rotated->line_depth)
+			rotated->line_depth = depth;
+		if (burst < rotated->burst_bytes)
+			rotated->burst_bytes = burst;
+		if (efficiency < rotated->efficiency)
+			rotated->efficiency = efficiency;
+	}
+}
+
+static bool _vs_rotated_layout_better(const drm_vs_rotated_layout *a,
+				      const drm_vs_rotated_layout *b)
+{
+	if (a->efficiency != b->efficiency)
+		return a->efficiency > b->efficiency;
+	if (a->line_depth != b->line_depth)
+		return a->line_depth < b->line_depth;
+
+	return a->layout.size < b->layout.size;
+}
+
+int drm_vs_get_rotated_layout(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			      uint32_t rotation, drm_vs_rotated_layout *rotated)
+{
+	vs_mod_family family = _vs_get_mod_family(mod);
+	uint64_t tile_mask = vs_mod_family_tile_mask[family];
+	drm_vs_rotated_layout candidate;
+	uint32_t tile_mode;
+	bool found = false;
+
+	if (!rotated || !width || !height)
+		return -EINVAL;
+	if (rotation != VS_ROTATION_0 && rotation != VS_ROTATION_90 &&
+	    rotation != VS_ROTATION_180 && rotation != VS_ROTATION_270)
+		return -EINVAL;
+	if (!_vs_find_format(format)->layout[_vs_get_layout_variant(mod)].num_planes)
+		return -EINVAL;
+
+	for (tile_mode = 0; tile_mode <= tile_mask; tile_mode++) {
+		if (!_vs_tile_mode_usable(format, family, tile_mode))
+			continue;
+
+		memset(&candidate, 0, sizeof(candidate));
+		candidate.mod = (mod & ~tile_mask) | tile_mode;
+		candidate.width = width;
+		candidate.height = height;
+		drm_vs_get_align_size(&candidate.width, &candidate.height, format, candidate.mod);
+
+		if (drm_vs_bo_config(candidate.width, candidate.height, format, candidate.mod,
+				     candidate.bo_param) ||
+		    drm_vs_get_bo_layout(candidate.width, candidate.height, format, candidate.mod,
+					 &candidate.layout))
+			continue;
+
+		_vs_rate_rotated_layout(format, rotation, &candidate);
+		if (!found || _vs_rotated_layout_better(&candidate, rotated)) {
+			*rotated = candidate;
+			found = true;
+		}
+	}
+
+	return found ? 0 : -EINVAL;
+}
+
+/* modifier types enumerated by drm_vs_negotiate_mod */
+static const uint8_t vs_negotiate_types[] = {
+	DRM_FORMAT_MOD_VS_TYPE_NORMAL,	DRM_FORMAT_MOD_VS_TYPE_COMPRESSED,
+	DRM_FORMAT_MOD_VS_TYPE_DEC400A,	DRM_FORMAT_MOD_VS_TYPE_PVRIC,
+	DRM_FORMAT_MOD_VS_TYPE_DECNANO,	DRM_FORMAT_MOD_VS_TYPE_ETC2,
+};
+
+static const drm_vs_mod_cost_model vs_default_cost_model = {
+	.rotation = VS_ROTATION_0,
+	.compress_ratio = 50,
+	.size_weight = 1,
+	.fetch_weight = 1,
+};
+
+/*
+ * Bytes the display reads for one frame: compressed data at the expected
+ * ratio plus tile status/header for lossless DEC400/DEC400A/PVRIC, the
+ * allocated data otherwise, scaled by the burst efficiency of the scan.
+ */
+static uint64_t _vs_get_fetch_bytes(uint32_t format, const drm_vs_mod_cost_model *model,
+				    drm_vs_rotated_layout *rated)
+{
+	const drm_vs_bo_layout *layout = &rated->layout;
+	uint64_t data, fetch = 0;
+	uint32_t i;
+
+	for (i = 0; i < layout->num_planes; i++) {
+		data = layout->plane_size[i] - layout->ts_size[i];
+
+		switch (_vs_get_mod_family(layout->modifiers[i])) {
+		case VS_MOD_FAMILY_DEC400:
+		case VS_MOD_FAMILY_DEC400A:
+		case VS_MOD_FAMILY_PVRIC:
+			if (!(layout->modifiers[i] & DRM_FORMAT_MOD_VS_DEC_LOSSY))
+				data = data * model->compress_ratio / 100;
+			fetch += data + layout->ts_size[i];
+			break;
+		default:
+			fetch += data;
+			break;
+		}
+	}
+
+	_vs_rate_rotated_layout(format, model->rotation, rated);
+
+	return fetch * 100 / (rated->efficiency ? rated->efficiency : 1);
+}
+
+static int _vs_rank_mod(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			const drm_vs_mod_cost_model *model, drm_vs_mod_rank *rank)
+{
+	drm_vs_rotated_layout rated;
+
+	memset(&rated, 0, sizeof(rated));
+	rated.mod = mod;
+	rated.width = width;
+	rated.height = height;
+	drm_vs_get_align_size(&rated.width, &rated.height, format, mod);
+	if (drm_vs_get_bo_layout(rated.width, rated.height, format, mod, &rated.layout))
+		return -EINVAL;
+
+	rank->mod = mod;
+	rank->size = rated.layout.size;
+	rank->fetch_bytes = _vs_get_fetch_bytes(format, model, &rated);
+	rank->cost = rank->size * model->size_weight + rank->fetch_bytes * model->fetch_weight;
+
+	return 0;
+}
+
+/* fixed rate DECNano/ETC2 blocks, and DEC_LOSSY of the compressed families */
+static bool _vs_mod_is_lossy(uint64_t mod)
+{
+	switch (_vs_get_mod_family(mod)) {
+	case VS_MOD_FAMILY_DECNANO:
+	case VS_MOD_FAMILY_ETC2:
+		return true;
+	case VS_MOD_FAMILY_DEC400:
+	case VS_MOD_FAMILY_DEC400A:
+	case VS_MOD_FAMILY_PVRIC:
+		return !!(mod & DRM_FORMAT_MOD_VS_DEC_LOSSY);
+	default:
+		return false;
+	}
+}
+
+/* keep @ranks sorted by cost, cheapest first, dropping the most expensive */
+static uint32_t _vs_insert_rank(drm_vs_mod_rank *ranks, uint32_t count, uint32_t max_ranks,
+				const drm_vs_mod_rank *rank)
+{
+	uint32_t i = count < max_ranks ? count : max_ranks;
+
+	if (i == max_ranks && (!i || ranks[i - 1].cost <= rank->cost))
+		return count;
+
+	if (i == max_ranks)
+		i--;
+	while (i && ranks[i - 1].cost > rank->cost) {
+		ranks[i] = ranks[i - 1];
+		i--;
+	}
+	ranks[i] = *rank;
+
+	return count < max_ranks ? count + 1 : count;
+}
+
+int drm_vs_negotiate_mod(uint32_t width, uint32_t height, uint32_t format, const uint64_t *mods,
+			 uint32_t num_mods, const drm_vs_mod_cost_model *model,
+			 drm_vs_mod_rank *ranks, uint32_t max_ranks)
+{
+	const vs_format_desc *fmt = _vs_find_format(format);
+	drm_vs_mod_rank rank;
+	vs_mod_family family;
+	uint32_t i, j, tile_mode, count = 0;
+	uint64_t mod;
+
+	if (!width || !height || !ranks || !max_ranks || (mods && !num_mods))
+		return -EINVAL;
+	if (!model)
+		model = &vs_default_cost_model;
+
+	if (mods) {
+		for (i = 0; i < num_mods; i++) {
+			if ((!model->allow_lossy && _vs_mod_is_lossy(mods[i])) ||
+			    !fmt->layout[_vs_get_layout_variant(mods[i])].num_planes ||
+			    _vs_rank_mod(width, height, format, mods[i], model, &rank))
+				continue;
+			count = _vs_insert_rank(ranks, count, max_ranks, &rank);
+		}
+
+		return count ? (int)count : -EINVAL;
+	}
+
+	/* every tile mode of every modifier family the format supports */
+	for (i = 0; i < sizeof(vs_negotiate_types) / sizeof(vs_negotiate_types[0]); i++) {
+		family = (vs_mod_family)vs_mod_family_tab[vs_negotiate_types[i]];
+		for (tile_mode = 0; tile_mode <= vs_mod_family_tile_mask[family]; tile_mode++) {
+			/* lossy PVRIC is the only DEC_LOSSY variant with a smaller layout */
+			for (j = 0; j < (family == VS_MOD_FAMILY_PVRIC ? 2u : 1u); j++) {
+				mod = fourcc_mod_vs_code(vs_negotiate_types[i], tile_mode) |
+				      (j ? DRM_FORMAT_MOD_VS_DEC_LOSSY : 0);
+				if ((!model->allow_lossy && _vs_mod_is_lossy(mod)) ||
+				    !fmt->layout[_vs_get_layout_variant(mod)].num_planes ||
+				    !_vs_tile_mode_usable(format, family, tile_mode) ||
+				    _vs_rank_mod(width, height, format, mod, model, &rank))
+					continue;
+				count = _vs_insert_rank(ranks, count, max_ranks, &rank);
+			}
+		}
+	}
+
+	return count ? (int)count : -EINVAL;
+}
+
+/* read bandwidth of @plane on a display of @display_height lines at @refresh */
+static int _vs_estimate_plane_bandwidth(drm_vs_bw_plane *plane, uint32_t display_width,
+					uint32_t display_height, uint32_t refresh,
+					const drm_vs_mod_cost_model *model)
+{
+	uint32_t src_w = plane->src_w, src_h = plane->src_h, dst_h = plane->dst_h;
+	drm_vs_rotated_layout rated;
+	uint64_t fetch, ts = 0;
+	uint32_t i;
+
+	if (!src_w || !src_h) {
+		src_w = display_width;
+		src_h = display_height;
+	}
+	/* unscaled, the source turns on its side for 90/270 degrees */
+	if (!plane->dst_w || !dst_h)
+		dst_h = model->rotation == VS_ROTATION_90 || model->rotation == VS_ROTATION_270 ?
+				src_w :
+				src_h;
+
+	memset(&rated, 0, sizeof(rated));
+	rated.mod = plane->mod;
+	rated.width = src_w;
+	rated.height = src_h;
+	drm_vs_get_align_size(&rated.width, &rated.height, plane->format, plane->mod);
+	if (drm_vs_get_bo_layout(rated.width, rated.height, plane->format, plane->mod,
+				 &rated.layout))
+		return -EINVAL;
+
+	fetch = _vs_get_fetch_bytes(plane->format, model, &rated);
+	for (i = 0; i < rated.layout.num_planes; i++)
+		ts += rated.layout.ts_size[i];
+
+	plane->bandwidth = fetch * refresh;
+	plane->ts_bandwidth = ts * refresh;
+	/* all source lines are read while the plane's dst_h lines scan out */
+	plane->peak_bandwidth = dst_h < display_height ?
+					plane->bandwidth * display_height / dst_h :
+					plane->bandwidth;
+
+	return 0;
+}
+
+int drm_vs_estimate_bandwidth(drm_vs_bw_display *displays, uint32_t num_displays,
+			      const drm_vs_mod_cost_model *model, uint64_t *total)
+{
+	drm_vs_bw_display *display;
+	uint32_t i, j, width, height;
+	int ret;
+
+	if (!displays || !total || num_displays > VS_DISPLAY_COUNT)
+		return -EINVAL;
+	if (!model)
+		model = &vs_default_cost_model;
+
+	*total = 0;
+	for (i = 0; i < num_displays; i++) {
+		display = &displays[i];
+		display->bandwidth = 0;
+		display->peak_bandwidth = 0;
+
+		if (_drm_vs_display_size_convert(display->mode, &width, &height,
+						 &display->refresh))
+			return -EINVAL;
+
+		for (j = 0; j < display->num_planes; j++) {
+			ret = _vs_estimate_plane_bandwidth(&display->planes[j], width, height,
+							   display->refresh, model);
+			if (ret) {
+				fprintf(stderr, "plane %u of display %u cannot be fetched\n", j, i);
+				return ret;
+			}
+
+			display->bandwidth += display->planes[j].bandwidth;
+			display->peak_bandwidth += display->planes[j].peak_bandwidth;
+		}
+
+		*total += display->bandwidth;
+	}
+
+	return 0;
+}
+
+/* bytes per pixel of the scaler line buffer */
+#define VS_SCALER_PIXEL_SIZE 4
+
+static int _vs_admit_plane(drm_vs_admit_plane *plane, uint32_t display_width,
+			   uint32_t display_height, uint32_t refresh,
+			   const drm_vs_dpu_limits *limits)
+{
+	drm_vs_mod_cost_model model = vs_default_cost_model;
+	drm_vs_bw_plane bw_plane = { 0 };
+	uint32_t src_w = plane->src.w, src_h = plane->src.h;
+	uint8_t tap_h, tap_v;
+	int ret;
+
+	plane->bandwidth = 0;
+	plane->scale_h = 0;
+	plane->scale_v = 0;
+	plane->line_buffer = 0;
+
+	if (!plane->src.w || !plane->src.h || !plane->dst.w || !plane->dst.h)
+		return -EINVAL;
+	if (plane->rotation != VS_ROTATION_0 && plane->rotation != VS_ROTATION_90 &&
+	    plane->rotation != VS_ROTATION_180 && plane->rotation != VS_ROTATION_270)
+		return -EINVAL;
+
+	/* scaling applies after rotation */
+	if (plane->rotation == VS_ROTATION_90 || plane->rotation == VS_ROTATION_270) {
+		src_w = plane->src.h;
+		src_h = plane->src.w;
+	}
+
+	plane->scale_h = drm_vs_get_stretch_factor(src_w, plane->dst.w, false);
+	plane->scale_v = drm_vs_get_stretch_factor(src_h, plane->dst.h, false);
+	drm_vs_get_filter_tap(plane->filter, &tap_h, &tap_v);
+	plane->line_buffer = (uint32_t)tap_v * src_w * VS_SCALER_PIXEL_SIZE;
+
+	model.rotation = plane->rotation;
+	model.compress_ratio = limits->compress_ratio;
+	bw_plane.src_w = plane->src.w;
+	bw_plane.src_h = plane->src.h;
+	bw_plane.dst_w = plane->dst.w;
+	bw_plane.dst_h = plane->dst.h;
+	bw_plane.format = plane->format;
+	bw_plane.mod = plane->mod;
+	ret = _vs_estimate_plane_bandwidth(&bw_plane, display_width, display_height, refresh,
+					   &model);
+	if (ret)
+		return ret;
+	plane->bandwidth = bw_plane.peak_bandwidth;
+
+	if ((uint64_t)plane->dst.x + plane->dst.w > display_width ||
+	    (uint64_t)plane->dst.y + plane->dst.h > display_height)
+		return -ERANGE;
+
+	/* factors of 0 are 1:1 or 1 pixel sources, which any scaler takes */
+	if (plane->scale_h > limits->max_downscale || plane->scale_v > limits->max_downscale)
+		return -ERANGE;
+	if (((uint64_t)plane->dst.w << 16) > (uint64_t)src_w * limits->max_upscale ||
+	    ((uint64_t)plane->dst.h << 16) > (uint64_t)src_h * limits->max_upscale)
+		return -ERANGE;
+
+	/* an unscaled plane bypasses the vertical filter */
+	if (src_h != plane->dst.h && plane->line_buffer > limits->line_buffer_size)
+		return -ERANGE;
+
+	return 0;
+}
+
+int drm_vs_admit_planes(vs_display_id display_id, drm_vs_admit_plane *planes,
+			uint32_t num_planes, const drm_vs_dpu_limits *limits, uint64_t *bandwidth)
+{
+	uint32_t width, height, refresh, i;
+	uint64_t total = 0;
+	int ret = 0;
+
+	if (display_id >= VS_DISPLAY_COUNT || (!planes && num_planes) || !limits)
+		return -EINVAL;
+
+	width = context.display_width[display_id];
+	height = context.display_height[display_id];
+	refresh = context.display_refresh[display_id];
+	if (!width || !height || !refresh)
+		return -EINVAL;
+
+	for (i = 0; i < num_planes; i++) {
+		planes[i].status = _vs_admit_plane(&planes[i], width, height, refresh, limits);
+		total += planes[i].bandwidth;
+
+		/* report the first failure, invalid planes before limits */
+		if (planes[i].status == -EINVAL || (planes[i].status && !ret))
+			ret = planes[i].status;
+	}
+
+	if (bandwidth)
+		*bandwidth = total;
+
+	if (!ret && total > limits->fetch_bandwidth)
+		ret = -ENOSPC;
+
+	return ret;
+}
+
+static uint64_t _vs_rect_area(const struct drm_vs_rect *rect)
+{
+	return (uint64_t)rect->w * rect->h;
+}
+
+static void _vs_rect_union(const struct drm_vs_rect *a, const struct drm_vs_rect *b,
+			   struct drm_vs_rect *u)
+{
+	uint32_t x1 = VS_MAX(a->x + a->w, b->x + b->w), y1 = VS_MAX(a->y + a->h, b->y + b->h);
+
+	u->x = VS_MIN(a->x, b->x);
+	u->y = VS_MIN(a->y, b->y);
+	u->w = x1 - u->x;
+	u->h = y1 - u->y;
+}
+
+/* bytes the union of two rectangles adds over their own areas, 0 if it adds none */
+static uint64_t _vs_rect_merge_waste(const struct drm_vs_rect *a, const struct drm_vs_rect *b)
+{
+	struct drm_vs_rect u;
+
+	_vs_rect_union(a, b, &u);
+	if (_vs_rect_area(&u) <= _vs_rect_area(a) + _vs_rect_area(b))
+		return 0;
+
+	return _vs_rect_area(&u) - _vs_rect_area(a) - _vs_rect_area(b);
+}
+
+/*
+ * Add @rect to @count dirty rectangles, room for VS_MAX_DAMAGE_RECTS + 1,
+ * merging pairs whose union costs nothing and, past VS_MAX_DAMAGE_RECTS,
+ * the pair whose union adds the fewest pixels.
+ */
+static void _vs_damage_add_rect(struct drm_vs_rect *rects, uint32_t *count,
+				const struct drm_vs_rect *rect)
+{
+	uint64_t waste, best;
+	uint32_t i, j, a = 0, b = 0;
+
+	rects[(*count)++] = *rect;
+
+	for (;;) {
+		best = UINT64_MAX;
+		for (i = 0; i < *count; i++) {
+			for (j = i + 1; j < *count; j++) {
+				waste = _vs_rect_merge_waste(&rects[i], &rects[j]);
+				if (waste < best) {
+					best = waste;
+					a = i;
+					b = j;
+				}
+			}
+		}
+
+		if (best && *count <= VS_MAX_DAMAGE_RECTS)
+			break;
+
+		_vs_rect_union(&rects[a], &rects[b], &rects[a]);
+		rects[b] = rects[--(*count)];
+	}
+}
+
+static int _vs_byte_range_cmp(const void *a, const void *b)
+{
+	const drm_vs_byte_range *ra = a, *rb = b;
+
+	if (ra->offset != rb->offset)
+		return ra->offset < rb->offset ? -1 : 1;
+
+	return 0;
+}
+
+static int _vs_gap_cmp(const void *a, const void *b)
+{
+	uint64_t ga = *(const uint64_t *)a, gb = *(const uint64_t *)b;
+
+	return ga < gb ? -1 : (ga > gb);
+}
+
+/*
+ * Sort and merge @count ranges in place, then close the smallest gaps until
+ * at most @max remain. Return the number of ranges.
+ */
+static uint32_t _vs_merge_ranges(drm_vs_byte_range *ranges, uint32_t count, uint32_t max,
+				 uint64_t *gaps)
+{
+	uint64_t end, threshold = 0;
+	uint32_t i, n = 0, merges;
+
+	if (!count)
+		return 0;
+
+	qsort(ranges, count, sizeof(ranges[0]), _vs_byte_range_cmp);
+	for (i = 1; i < count; i++) {
+		end = ranges[n].offset + ranges[n].size;
+		if (ranges[i].offset <= end) {
+			if (ranges[i].offset + ranges[i].size > end)
+				ranges[n].size = ranges[i].offset + ranges[i].size - ranges[n].offset;
+		} else {
+			ranges[++n] = ranges[i];
+		}
+	}
+	count = n + 1;
+
+	if (count <= max)
+		return count;
+
+	/* the count - max smallest gaps go, ties in address order */
+	for (i = 1; i < count; i++)
+		gaps[i - 1] = ranges[i].offset - ranges[i - 1].offset - ranges[i - 1].size;
+	qsort(gaps, count - 1, sizeof(gaps[0]), _vs_gap_cmp);
+	merges = count - max;
+	threshold = gaps[merges - 1];
+	for (i = 0; i < count - 1; i++)
+		merges -= gaps[i] < threshold;
+
+	n = 0;
+	for (i = 1; i < count; i++) {
+		end = ranges[n].offset + ranges[n].size;
+		if (ranges[i].offset - end < threshold ||
+		    (ranges[i].offset - end == threshold && merges && merges--))
+			ranges[n].size = ranges[i].offset + ranges[i].size - ranges[n].offset;
+		else
+			ranges[++n] = ranges[i];
+	}
+
+	return n + 1;
+}
+
+int drm_vs_map_damage(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+		      const struct drm_vs_rect *damage, uint32_t num_damage,
+		      drm_vs_damage_map *map)
+{
+	drm_vs_tile_geometry geometry;
+	drm_vs_format_desc desc;
+	drm_vs_bo_layout layout;
+	struct drm_vs_rect rect, rects[VS_MAX_DAMAGE_RECTS + 1];
+	drm_vs_byte_range *data = NULL, *ts = NULL;
+	vs_mod_family family[4];
+	uint64_t align_x = 1, align_y = 1, x, span[4] = { 0 }, row_bytes, start, end;
+	uint64_t ts_pitch, ts_start, ts_size, x0, x1, count = 0, *gaps = NULL;
+	uint32_t i, j, r, ty, sb_w = 0, tile_w, tile_h, plane_w, packed;
+	uint32_t num_data = 0, num_ts = 0;
+	int ret;
+
+	if (!map || (!damage && num_damage) || (map->max_data && !map->data) ||
+	    (map->max_ts && !map->ts))
+		return -EINVAL;
+
+	map->num_rects = 0;
+	map->num_data = 0;
+	map->num_ts = 0;
+	map->data_bytes = 0;
+	map->ts_bytes = 0;
+
+	ret = drm_vs_get_bo_layout(width, height, format, mod, &layout);
+	if (ret)
+		return ret;
+	if (drm_vs_get_format_desc(format, mod, &desc) ||
+	    drm_vs_get_tile_geometry(format, mod, &geometry))
+		return -EINVAL;
+
+	/* whole tiles of every plane and whole tile status bytes */
+	for (i = 0; i < desc.num_planes; i++) {
+		if (!geometry.width[i] || !geometry.height[i])
+			return -EINVAL;
+
+		family[i] = _vs_get_mod_family(layout.modifiers[i]);
+		x = geometry.width[i];
+		if (family[i] == VS_MOD_FAMILY_DEC400) {
+			span[i] = _vs_get_ts_byte_span(layout.modifiers[i], desc.bpp[i]);
+			x = _vs_lcm(x, span[i] * 8 /
+					       _vs_gcd(span[i] * 8,
+						       (uint64_t)desc.bpp[i] * geometry.height[i]));
+		} else if (family[i] == VS_MOD_FAMILY_DEC400A) {
+			_vs_get_dec400a_superblock(format, &sb_w, NULL);
+			x = _vs_lcm(x, sb_w);
+		} else if (family[i] == VS_MOD_FAMILY_PVRIC) {
+			/* one header byte per 256 byte tile */
+			span[i] = 256;
+			x = _vs_lcm(x, span[i] * 8 /
+					       _vs_gcd(span[i] * 8,
+						       (uint64_t)desc.bpp[i] * geometry.height[i]));
+		}
+		align_x = _vs_lcm(align_x, x * desc.hsub[i]);
+		align_y = _vs_lcm(align_y, (uint64_t)geometry.height[i] * desc.vsub[i]);
+	}
+
+	for (r = 0; r < num_damage; r++) {
+		if (!damage[r].w || !damage[r].h || damage[r].x >= width || damage[r].y >= height)
+			continue;
+
+		x0 = damage[r].x / align_x * align_x;
+		x1 = VS_MIN((uint64_t)damage[r].x + damage[r].w, width);
+		x1 = VS_MIN((x1 + align_x - 1) / align_x * align_x, width);
+		rect.x = x0;
+		rect.w = x1 - x0;
+		x0 = damage[r].y / align_y * align_y;
+		x1 = VS_MIN((uint64_t)damage[r].y + damage[r].h, height);
+		x1 = VS_MIN((x1 + align_y - 1) / align_y * align_y, height);
+		rect.y = x0;
+		rect.h = x1 - x0;
+
+		_vs_damage_add_rect(rects, &map->num_rects, &rect);
+	}
+	memcpy(map->rects, rects, sizeof(map->rects[0]) * map->num_rects);
+	if (!map->num_rects)
+		return 0;
+
+	/* one range per tile row of each plane */
+	for (r = 0; r < map->num_rects; r++) {
+		for (i = 0; i < desc.num_planes; i++)
+			count += (map->rects[r].h / desc.vsub[i] + geometry.height[i] - 1) /
+					 geometry.height[i] +
+				 1;
+	}
+
+	data = malloc(sizeof(*data) * count);
+	ts = malloc(sizeof(*ts) * count);
+	gaps = malloc(sizeof(*gaps) * count);
+	if (!data || !ts || !gaps) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (r = 0; r < map->num_rects; r++) {
+		for (i = 0; i < desc.num_planes; i++) {
+			tile_w = geometry.width[i];
+			tile_h = geometry.height[i];
+			plane_w = width / desc.hsub[i];
+			x0 = map->rects[r].x / desc.hsub[i];
+			x1 = (map->rects[r].x + map->rects[r].w) / desc.hsub[i];
+
+			/* bytes of the rectangle within a tile row */
+			if (family[i] == VS_MOD_FAMILY_DECNANO || family[i] == VS_MOD_FAMILY_ETC2) {
+				/* rows of fixed rate blocks */
+				row_bytes = (uint64_t)(plane_w + tile_w - 1) / tile_w * geometry.bytes[i];
+				start = x0 / tile_w * geometry.bytes[i];
+				end = (x1 + tile_w - 1) / tile_w * geometry.bytes[i];
+			} else {
+				row_bytes = (uint64_t)layout.pitches[i] * tile_h;
+				start = x0 * desc.bpp[i] / 8 * tile_h;
+				end = x1 * desc.bpp[i] / 8 * tile_h;
+			}
+
+			/* tile status/header of the rectangle within a tile row */
+			switch (family[i]) {
+			case VS_MOD_FAMILY_DEC400:
+			case VS_MOD_FAMILY_PVRIC:
+				ts_pitch = (uint64_t)layout.pitches[i] * tile_h / span[i];
+				ts_start = start / span[i];
+				ts_size = (end - start) / span[i];
+				break;
+			case VS_MOD_FAMILY_DEC400A:
+				ts_pitch = (plane_w + sb_w - 1) / sb_w * VS_DEC400A_HEADER_SIZE;
+				ts_start = x0 / sb_w * VS_DEC400A_HEADER_SIZE;
+				ts_size = ((x1 + sb_w - 1) / sb_w - x0 / sb_w) * VS_DEC400A_HEADER_SIZE;
+				break;
+			default:
+				ts_pitch = 0;
+				ts_start = 0;
+				ts_size = 0;
+				break;
+			}
+
+			/* lossy PVRIC tiles are packed to a fixed 128 or 96 bytes */
+			if (family[i] == VS_MOD_FAMILY_PVRIC &&
+			    (layout.modifiers[i] & DRM_FORMAT_MOD_VS_DEC_LOSSY)) {
+				packed = _vs_get_pvric_lossy_bytes(format);
+				row_bytes = row_bytes / 256 * packed;
+				start = start / 256 * packed;
+				end = end / 256 * packed;
+			}
+
+			for (ty = map->rects[r].y / desc.vsub[i] / tile_h;
+			     ty * tile_h < (map->rects[r].y + map->rects[r].h) / desc.vsub[i]; ty++) {
+				data[num_data].offset = layout.offsets[i] + ty * row_bytes + start;
+				data[num_data++].size = end - start;
+
+				if (ts_size) {
+					ts[num_ts].offset = layout.ts_offsets[i] + ty * ts_pitch + ts_start;
+					ts[num_ts++].size = ts_size;
+				}
+			}
+		}
+	}
+
+	/* no array, no ranges of that kind */
+	num_data = map->max_data ? _vs_merge_ranges(data, num_data, map->max_data, gaps) : 0;
+	num_ts = map->max_ts ? _vs_merge_ranges(ts, num_ts, map->max_ts, gaps) : 0;
+
+	for (j = 0; j < num_data; j++) {
+		map->data[j] = data[j];
+		map->data_bytes += data[j].size;
+	}
+	for (j = 0; j < num_ts; j++) {
+		map->ts[j] = ts[j];
+		map->ts_bytes += ts[j].size;
+	}
+	map->num_data = num_data;
+	map->num_ts = num_ts;
+
+out:
+	free(data);
+	free(ts);
+	free(gaps);
+
+	return ret;
+}
+
+int drm_vs_fill_fb_cmd2_layout(uint32_t width, uint32_t height, uint32_t format,
+			       const drm_vs_bo_layout *layout, uint32_t handle,
+			       struct drm_mode_fb_cmd2 *fb)
+{
+	uint64_t offset;
+	uint32_t i;
+
+	if (!layout || !fb || !layout->num_planes || layout->num_planes > 4)
+		return -EINVAL;
+
+	memset(fb, 0, sizeof(*fb));
+
+	for (i = 0; i < layout->num_planes; i++) {
+		/* a PVRIC plane starts with its header */
+		offset = fourcc_mod_vs_is_pvric(layout->modifiers[i]) ? layout->ts_offsets[i] :
+									 layout->offsets[i];
+		if (offset > UINT32_MAX)
+			return -ERANGE;
+
+		fb->handles[i] = handle;
+		fb->pitches[i] = layout->pitches[i];
+		fb->offsets[i] = offset;
+		fb->modifier[i] = layout->modifiers[i];
+	}
+
+	fb->width = width;
+	fb->height = height;
+	fb->pixel_format = format;
+	fb->flags = DRM_MODE_FB_MODIFIERS;
+
+	return 0;
+}
+
+int drm_vs_fill_fb_cmd2(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			const uint32_t *handles, uint32_t num_handles, struct drm_mode_fb_cmd2 *fb)
+{
+	uint32_t align_w = width, align_h = height;
+	drm_vs_bo_param bo_param[4];
+	drm_vs_bo_layout layout;
+	uint32_t i;
+	int ret;
+
+	if (!handles || !fb || !num_handles)
+		return -EINVAL;
+
+	memset(fb, 0, sizeof(*fb));
+	drm_vs_get_align_size(&align_w, &align_h, format, mod);
+
+	if (num_handles == 1) {
+		/* all planes in one buffer, see drm_vs_get_bo_layout */
+		ret = drm_vs_get_bo_layout(align_w, align_h, format, mod, &layout);
+		if (ret)
+			return ret;
+
+		return drm_vs_fill_fb_cmd2_layout(width, height, format, &layout, handles[0], fb);
+	} else {
+		/* one buffer per plane, as allocated with drm_vs_bo_config */
+		ret = drm_vs_bo_config_ext(align_w, align_h, format, mod, bo_param, fb->modifier);
+		if (ret)
+			return ret;
+
+		for (i = 0; i < 4 && bo_param[i].bpp; i++) {
+			if (i >= num_handles)
+				return -EINVAL;
+
+			fb->handles[i] = handles[i];
+			fb->pitches[i] = bo_param[i].width * bo_param[i].bpp / 8;
+		}
+	}
+
+	fb->width = width;
+	fb->height = height;
+	fb->pixel_format = format;
+	fb->flags = DRM_MODE_FB_MODIFIERS;
+
+	return 0;
+}
+
+#define VS_PLAN_PAGE_SIZE 4096ull
+
+/* bytes of one buffer of @plane with @mod, and its tile status/header part */
+static int _vs_plan_buffer_size(const drm_vs_plan_plane *plane, vs_display_size_type mode,
+				uint64_t mod, uint64_t *size, uint64_t *overhead)
+{
+	uint32_t width = plane->width, height = plane->height;
+	drm_vs_bo_param64 bo_param[4];
+	uint64_t modifiers[4];
+	uint32_t i;
+	int ret;
+
+	if (!width || !height) {
+		if (_drm_vs_display_size_convert(mode, &width, &height, NULL))
+			return -EINVAL;
+	}
+
+	drm_vs_get_align_size(&width, &height, plane->format, mod);
+	ret = drm_vs_bo_config64(width, height, plane->format, mod, bo_param, modifiers);
+	if (ret)
+		return ret;
+
+	*size = 0;
+	*overhead = 0;
+	for (i = 0; i < 4 && bo_param[i].bpp; i++) {
+		*size += VS_UP_ALIGN(bo_param[i].size, VS_PLAN_PAGE_SIZE);
+		*overhead += bo_param[i].ts_buf_size + bo_param[i].header_size;
+	}
+
+	return 0;
+}
+
+int drm_vs_plan_frame_memory(drm_vs_plan_display *displays, uint32_t num_displays,
+			     uint64_t *total)
+{
+	drm_vs_plan_display *display;
+	drm_vs_plan_plane *plane;
+	uint32_t i, j;
+	int ret;
+
+	if (!displays || !total || num_displays > VS_DISPLAY_COUNT)
+		return -EINVAL;
+
+	*total = 0;
+	for (i = 0; i < num_displays; i++) {
+		display = &displays[i];
+		display->total_size = 0;
+
+		for (j = 0; j < display->num_planes; j++) {
+			plane = &display->planes[j];
+
+			ret = _vs_plan_buffer_size(plane, display->mode, plane->mod,
+						   &plane->buffer_size, &plane->overhead);
+			if (ret) {
+				fprintf(stderr, "plane %u of display %u cannot be allocated\n", j, i);
+				return ret;
+			}
+
+			plane->total_size = plane->buffer_size * plane->num_buffers;
+			display->total_size += plane->total_size;
+		}
+
+		*total += display->total_size;
+	}
+
+	return 0;
+}
+
+int drm_vs_plan_choose_mod(const drm_vs_plan_display *displays, uint32_t num_displays,
+			   const uint64_t *mods, uint32_t num_mods, uint64_t cap, uint64_t *totals)
+{
+	const drm_vs_plan_display *display;
+	const drm_vs_plan_plane *plane;
+	uint64_t total, size, overhead;
+	uint32_t i, j, k;
+	int choice = -ENOSPC;
+
+	if (!displays || !mods || num_displays > VS_DISPLAY_COUNT)
+		return -EINVAL;
+
+	for (k = 0; k < num_mods; k++) {
+		total = 0;
+
+		for (i = 0; i < num_displays && total != UINT64_MAX; i++) {
+			display = &displays[i];
+
+			for (j = 0; j < display->num_planes; j++) {
+				plane = &display->planes[j];
+
+				/* formats without the candidate keep their own modifier */
+				if (_vs_plan_buffer_size(plane, display->mode, mods[k], &size,
+							 &overhead) &&
+				    _vs_plan_buffer_size(plane, display->mode, plane->mod, &size,
+							 &overhead)) {
+					total = UINT64_MAX;
+					break;
+				}
+
+				total += size * plane->num_buffers;
+			}
+		}
+
+		if (totals)
+			totals[k] = total;
+		if (choice < 0 && total <= cap)
+			choice = k;
+	}
+
+	return choice;
+}
+
 uint32_t drm_vs_get_ltm_norm(uint16_t *coef, uint32_t size)
 {
 #define VS_LTM_FREQ_NORM_FRAC_BIT 18
@@ -0,0 +1,1175 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VS_PACK_X86 1
+#elif defined(__ARM_NEON) && defined(VS_BO_PACK_NEON)
+/* opt-in until the NEON rows have been run on aarch64, see the Makefile */
+#include <arm_neon.h>
+#define VS_PACK_NEON 1
+#endif
+
+#include "vs_bo_helper.h"
+#include "vs_bo_pack.h"
+
+/* how the samples of a custom plane are packed */
+typedef enum _vs_pack_kind {
+	/* 10 bit samples one after another, low bits first */
+	VS_PACK_10BIT,
+	/* VS_PACK_10BIT from 8 bit samples, widened to the top of 10 bits */
+	VS_PACK_10BIT8,
+	/* three 10 bit samples in each 32 bit word */
+	VS_PACK_3IN32,
+	/* 10 bit samples in the low bits of 16 bits */
+	VS_PACK_LUMA10,
+	/* one 8 bit plane per color */
+	VS_PACK_RGB_PLANAR,
+	/* 16 bit RGB565 followed by 8 bit alpha */
+	VS_PACK_565A8,
+	VS_PACK_KIND_COUNT,
+} vs_pack_kind;
+
+typedef struct _vs_pack_desc {
+	uint32_t format;
+	uint32_t source;
+	vs_pack_kind kind;
+	/* byte of the XRGB8888 pixel stored in each RGB plane */
+	uint8_t order[3];
+	/* blue in the high bits of the 565 */
+	bool swap;
+} vs_pack_desc;
+
+/* the first entry of a format gives its default source */
+static const vs_pack_desc vs_pack_tab[] = {
+	{ DRM_FORMAT_RGB888, DRM_FORMAT_XRGB8888, VS_PACK_RGB_PLANAR, { 2, 1, 0 }, false },
+	{ DRM_FORMAT_BGR888, DRM_FORMAT_XRGB8888, VS_PACK_RGB_PLANAR, { 0, 1, 2 }, false },
+	{ DRM_FORMAT_NV12, DRM_FORMAT_P010, VS_PACK_10BIT, { 0 }, false },
+	{ DRM_FORMAT_NV12, DRM_FORMAT_NV12, VS_PACK_10BIT8, { 0 }, false },
+	{ DRM_FORMAT_YUV420_10BIT, DRM_FORMAT_P010, VS_PACK_3IN32, { 0 }, false },
+	{ DRM_FORMAT_P016, DRM_FORMAT_P010, VS_PACK_3IN32, { 0 }, false },
+	{ DRM_FORMAT_Y0L0, DRM_FORMAT_P010, VS_PACK_LUMA10, { 0 }, false },
+	{ DRM_FORMAT_RGB565_A8, DRM_FORMAT_ARGB8888, VS_PACK_565A8, { 0 }, false },
+	{ DRM_FORMAT_BGR565_A8, DRM_FORMAT_ARGB8888, VS_PACK_565A8, { 0 }, true },
+};
+
+/*
+ * One row of @n samples, or pixels for the RGB kinds. Planar RGB rows are
+ * passed as the three plane rows, the other kinds use custom[0] only.
+ */
+typedef void (*vs_pack_row_fn)(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			       const vs_pack_desc *desc);
+typedef void (*vs_unpack_row_fn)(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				 const vs_pack_desc *desc);
+
+static inline uint16_t _vs_load16(const uint8_t *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void _vs_store16(uint8_t *p, uint16_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+static inline uint32_t _vs_load32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void _vs_store32(uint8_t *p, uint32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+static inline uint64_t _vs_load64(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void _vs_store64(uint8_t *p, uint64_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+/* expand 5 or 6 bit colors to 8 bits by bit replication */
+static inline uint8_t _vs_expand5(uint32_t c)
+{
+	return c << 3 | c >> 2;
+}
+
+static inline uint8_t _vs_expand6(uint32_t c)
+{
+	return c << 2 | c >> 4;
+}
+
+static void _vs_pack_10bit_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			     const vs_pack_desc *desc)
+{
+	uint8_t *dst = custom[0];
+	uint64_t bits = 0;
+	uint32_t i, count = 0;
+
+	(void)desc;
+	for (i = 0; i < n; i++) {
+		bits |= (uint64_t)(_vs_load16(std + i * 2) >> 6) << count;
+		for (count += 10; count >= 8; count -= 8) {
+			*dst++ = bits;
+			bits >>= 8;
+		}
+	}
+	if (count)
+		*dst = bits;
+}
+
+static void _vs_unpack_10bit_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			       const vs_pack_desc *desc)
+{
+	const uint8_t *src = custom[0];
+	uint64_t bits = 0;
+	uint32_t i, count = 0;
+
+	(void)desc;
+	for (i = 0; i < n; i++) {
+		for (; count < 10; count += 8)
+			bits |= (uint64_t)*src++ << count;
+		_vs_store16(std + i * 2, (bits & 0x3ff) << 6);
+		bits >>= 10;
+		count -= 10;
+	}
+}
+
+static void _vs_pack_10bit8_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			      const vs_pack_desc *desc)
+{
+	uint8_t *dst = custom[0];
+	uint64_t bits = 0;
+	uint32_t i, count = 0;
+
+	(void)desc;
+	for (i = 0; i < n; i++) {
+		bits |= (uint64_t)std[i] << 2 << count;
+		for (count += 10; count >= 8; count -= 8) {
+			*dst++ = bits;
+			bits >>= 8;
+		}
+	}
+	if (count)
+		*dst = bits;
+}
+
+static void _vs_unpack_10bit8_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				const vs_pack_desc *desc)
+{
+	const uint8_t *src = custom[0];
+	uint64_t bits = 0;
+	uint32_t i, count = 0;
+
+	(void)desc;
+	for (i = 0; i < n; i++) {
+		for (; count < 10; count += 8)
+			bits |= (uint64_t)*src++ << count;
+		std[i] = (bits & 0x3ff) >> 2;
+		bits >>= 10;
+		count -= 10;
+	}
+}
+
+static void _vs_pack_3in32_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			     const vs_pack_desc *desc)
+{
+	uint32_t i, word;
+
+	(void)desc;
+	for (i = 0; i + 3 <= n; i += 3) {
+		word = _vs_load16(std + i * 2) >> 6;
+		word |= (uint32_t)(_vs_load16(std + i * 2 + 2) >> 6) << 10;
+		word |= (uint32_t)(_vs_load16(std + i * 2 + 4) >> 6) << 20;
+		_vs_store32(custom[0] + i / 3 * 4, word);
+	}
+}
+
+static void _vs_unpack_3in32_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			       const vs_pack_desc *desc)
+{
+	uint32_t i, word;
+
+	(void)desc;
+	for (i = 0; i + 3 <= n; i += 3) {
+		word = _vs_load32(custom[0] + i / 3 * 4);
+		_vs_store16(std + i * 2, (word & 0x3ff) << 6);
+		_vs_store16(std + i * 2 + 2, (word >> 10 & 0x3ff) << 6);
+		_vs_store16(std + i * 2 + 4, (word >> 20 & 0x3ff) << 6);
+	}
+}
+
+static void _vs_pack_luma10_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			      const vs_pack_desc *desc)
+{
+	uint32_t i;
+
+	(void)desc;
+	for (i = 0; i < n; i++)
+		_vs_store16(custom[0] + i * 2, _vs_load16(std + i * 2) >> 6);
+}
+
+static void _vs_unpack_luma10_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				const vs_pack_desc *desc)
+{
+	uint32_t i;
+
+	(void)desc;
+	for (i = 0; i < n; i++)
+		_vs_store16(std + i * 2, (_vs_load16(custom[0] + i * 2) & 0x3ff) << 6);
+}
+
+static void _vs_pack_rgb_planar_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				  const vs_pack_desc *desc)
+{
+	uint32_t i, k;
+
+	for (i = 0; i < n; i++)
+		for (k = 0; k < 3; k++)
+			custom[k][i] = std[i * 4 + desc->order[k]];
+}
+
+static void _vs_unpack_rgb_planar_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				    const vs_pack_desc *desc)
+{
+	uint32_t i, k;
+
+	for (i = 0; i < n; i++) {
+		for (k = 0; k < 3; k++)
+			std[i * 4 + desc->order[k]] = custom[k][i];
+		std[i * 4 + 3] = 0xff;
+	}
+}
+
+static void _vs_pack_565a8_c(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			     const vs_pack_desc *desc)
+{
+	uint32_t i, b, g, r;
+
+	for (i = 0; i < n; i++) {
+		b = std[i * 4] >> 3;
+		g = std[i * 4 + 1] >> 2;
+		r = std[i * 4 + 2] >> 3;
+		_vs_store16(custom[0] + i * 3,
+			    desc->swap ? b << 11 | g << 5 | r : r << 11 | g << 5 | b);
+		custom[0][i * 3 + 2] = std[i * 4 + 3];
+	}
+}
+
+static void _vs_unpack_565a8_c(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			       const vs_pack_desc *desc)
+{
+	uint32_t i, hi, lo;
+	uint16_t rgb;
+
+	for (i = 0; i < n; i++) {
+		rgb = _vs_load16(custom[0] + i * 3);
+		hi = _vs_expand5(rgb >> 11);
+		lo = _vs_expand5(rgb & 0x1f);
+		std[i * 4] = desc->swap ? hi : lo;
+		std[i * 4 + 1] = _vs_expand6(rgb >> 5 & 0x3f);
+		std[i * 4 + 2] = desc->swap ? lo : hi;
+		std[i * 4 + 3] = custom[0][i * 3 + 2];
+	}
+}
+
+#ifdef VS_PACK_X86
+/* byte shuffle mask, -1 clears the byte */
+#define VS_SHUF(...) _mm_setr_epi8(__VA_ARGS__)
+
+/* 8 samples of 10 bits in 16 bits into 10 bytes */
+__attribute__((target("ssse3"))) static inline void
+_vs_pack_10bit_8x_ssse3(uint8_t *dst, __m128i v)
+{
+	const __m128i pair = _mm_set1_epi32(0x04000001);
+	const __m128i low = _mm_set_epi32(0, -1, 0, -1);
+	const __m128i compact = VS_SHUF(0, 1, 2, 3, 4, 8, 9, 10, 11, 12, -1, -1, -1, -1, -1, -1);
+
+	/* s0 | s1 << 10 in 32 bits, then four samples in 40 of 64 bits */
+	v = _mm_madd_epi16(v, pair);
+	v = _mm_or_si128(_mm_and_si128(v, low), _mm_slli_epi64(_mm_srli_epi64(v, 32), 20));
+	v = _mm_shuffle_epi8(v, compact);
+	_mm_storel_epi64((__m128i *)dst, v);
+	_vs_store16(dst + 8, _mm_extract_epi16(v, 4));
+}
+
+__attribute__((target("ssse3"))) static inline __m128i
+_vs_unpack_10bit_8x_ssse3(const uint8_t *src)
+{
+	const __m128i spread = VS_SHUF(0, 1, 2, 3, 4, -1, -1, -1, 5, 6, 7, 8, 9, -1, -1, -1);
+	const __m128i low20 = _mm_set_epi32(0, 0xfffff, 0, 0xfffff);
+	const __m128i low10 = _mm_set1_epi32(0x3ff);
+	__m128i v;
+
+	v = _mm_insert_epi16(_mm_loadl_epi64((const __m128i *)src), _vs_load16(src + 8), 4);
+	/* four samples in 40 of 64 bits, then two in 32, then one in 16 */
+	v = _mm_shuffle_epi8(v, spread);
+	v = _mm_or_si128(_mm_and_si128(v, low20), _mm_slli_epi64(_mm_srli_epi64(v, 20), 32));
+	return _mm_or_si128(_mm_and_si128(v, low10), _mm_slli_epi32(_mm_srli_epi32(v, 10), 16));
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_pack_10bit_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+		     const vs_pack_desc *desc)
+{
+	uint8_t *dst = custom[0];
+	__m128i v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, dst += 10) {
+		v = _mm_loadu_si128((const __m128i *)(std + i * 2));
+		_vs_pack_10bit_8x_ssse3(dst, _mm_srli_epi16(v, 6));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { dst };
+
+		_vs_pack_10bit_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_10bit_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+		       const vs_pack_desc *desc)
+{
+	const uint8_t *src = custom[0];
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, src += 10)
+		_mm_storeu_si128((__m128i *)(std + i * 2),
+				 _mm_slli_epi16(_vs_unpack_10bit_8x_ssse3(src), 6));
+
+	if (i < n) {
+		const uint8_t *rest[3] = { src };
+
+		_vs_unpack_10bit_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_pack_10bit8_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+		      const vs_pack_desc *desc)
+{
+	const __m128i zero = _mm_setzero_si128();
+	uint8_t *dst = custom[0];
+	__m128i v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, dst += 10) {
+		v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(std + i)), zero);
+		_vs_pack_10bit_8x_ssse3(dst, _mm_slli_epi16(v, 2));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { dst };
+
+		_vs_pack_10bit8_c(rest, std + i, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_10bit8_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			const vs_pack_desc *desc)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const uint8_t *src = custom[0];
+	__m128i v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, src += 10) {
+		v = _mm_srli_epi16(_vs_unpack_10bit_8x_ssse3(src), 2);
+		_mm_storel_epi64((__m128i *)(std + i), _mm_packus_epi16(v, zero));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { src };
+
+		_vs_unpack_10bit8_c(std + i, rest, n - i, desc);
+	}
+}
+
+/* 12 samples into 4 words */
+__attribute__((target("ssse3"))) static void
+_vs_pack_3in32_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+		     const vs_pack_desc *desc)
+{
+	const __m128i a0 = VS_SHUF(0, 1, -1, -1, 6, 7, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1);
+	const __m128i a1 = VS_SHUF(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 3, -1, -1);
+	const __m128i b0 = VS_SHUF(2, 3, -1, -1, 8, 9, -1, -1, 14, 15, -1, -1, -1, -1, -1, -1);
+	const __m128i b1 = VS_SHUF(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, 5, -1, -1);
+	const __m128i c0 = VS_SHUF(4, 5, -1, -1, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i c1 = VS_SHUF(-1, -1, -1, -1, -1, -1, -1, -1, 0, 1, -1, -1, 6, 7, -1, -1);
+	__m128i r0, r1, a, b, c;
+	uint32_t i;
+
+	for (i = 0; i + 12 <= n; i += 12) {
+		r0 = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)(std + i * 2)), 6);
+		r1 = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *)(std + i * 2 + 16)), 6);
+		a = _mm_or_si128(_mm_shuffle_epi8(r0, a0), _mm_shuffle_epi8(r1, a1));
+		b = _mm_or_si128(_mm_shuffle_epi8(r0, b0), _mm_shuffle_epi8(r1, b1));
+		c = _mm_or_si128(_mm_shuffle_epi8(r0, c0), _mm_shuffle_epi8(r1, c1));
+		a = _mm_or_si128(a, _mm_or_si128(_mm_slli_epi32(b, 10), _mm_slli_epi32(c, 20)));
+		_mm_storeu_si128((__m128i *)(custom[0] + i / 3 * 4), a);
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i / 3 * 4 };
+
+		_vs_pack_3in32_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_3in32_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+		       const vs_pack_desc *desc)
+{
+	const __m128i a0 = VS_SHUF(0, 1, -1, -1, -1, -1, 4, 5, -1, -1, -1, -1, 8, 9, -1, -1);
+	const __m128i b0 = VS_SHUF(-1, -1, 0, 1, -1, -1, -1, -1, 4, 5, -1, -1, -1, -1, 8, 9);
+	const __m128i c0 = VS_SHUF(-1, -1, -1, -1, 0, 1, -1, -1, -1, -1, 4, 5, -1, -1, -1, -1);
+	const __m128i a1 = VS_SHUF(-1, -1, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i b1 = VS_SHUF(-1, -1, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i c1 = VS_SHUF(8, 9, -1, -1, -1, -1, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i low10 = _mm_set1_epi32(0x3ff);
+	__m128i w, a, b, c, r;
+	uint32_t i;
+
+	for (i = 0; i + 12 <= n; i += 12) {
+		w = _mm_loadu_si128((const __m128i *)(custom[0] + i / 3 * 4));
+		a = _mm_slli_epi32(_mm_and_si128(w, low10), 6);
+		b = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 10), low10), 6);
+		c = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 20), low10), 6);
+		r = _mm_or_si128(_mm_shuffle_epi8(a, a0),
+				 _mm_or_si128(_mm_shuffle_epi8(b, b0), _mm_shuffle_epi8(c, c0)));
+		_mm_storeu_si128((__m128i *)(std + i * 2), r);
+		r = _mm_or_si128(_mm_shuffle_epi8(a, a1),
+				 _mm_or_si128(_mm_shuffle_epi8(b, b1), _mm_shuffle_epi8(c, c1)));
+		_mm_storel_epi64((__m128i *)(std + i * 2 + 16), r);
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i / 3 * 4 };
+
+		_vs_unpack_3in32_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_pack_luma10_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+		      const vs_pack_desc *desc)
+{
+	__m128i v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		v = _mm_loadu_si128((const __m128i *)(std + i * 2));
+		_mm_storeu_si128((__m128i *)(custom[0] + i * 2), _mm_srli_epi16(v, 6));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i * 2 };
+
+		_vs_pack_luma10_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_luma10_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			const vs_pack_desc *desc)
+{
+	const __m128i low10 = _mm_set1_epi16(0x3ff);
+	__m128i v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		v = _mm_and_si128(_mm_loadu_si128((const __m128i *)(custom[0] + i * 2)), low10);
+		_mm_storeu_si128((__m128i *)(std + i * 2), _mm_slli_epi16(v, 6));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i * 2 };
+
+		_vs_unpack_luma10_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+/* 16 pixels into 16 bytes of each plane */
+__attribute__((target("ssse3"))) static void
+_vs_pack_rgb_planar_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+			  const vs_pack_desc *desc)
+{
+	const __m128i group = VS_SHUF(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+	__m128i v[4], t[4], c[3];
+	uint32_t i, k;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		/* byte k of four pixels in dword k, then a 4x4 dword transpose */
+		for (k = 0; k < 4; k++)
+			v[k] = _mm_shuffle_epi8(
+				_mm_loadu_si128((const __m128i *)(std + i * 4 + k * 16)), group);
+		t[0] = _mm_unpacklo_epi32(v[0], v[1]);
+		t[1] = _mm_unpackhi_epi32(v[0], v[1]);
+		t[2] = _mm_unpacklo_epi32(v[2], v[3]);
+		t[3] = _mm_unpackhi_epi32(v[2], v[3]);
+		c[0] = _mm_unpacklo_epi64(t[0], t[2]);
+		c[1] = _mm_unpackhi_epi64(t[0], t[2]);
+		c[2] = _mm_unpacklo_epi64(t[1], t[3]);
+		for (k = 0; k < 3; k++)
+			_mm_storeu_si128((__m128i *)(custom[k] + i), c[desc->order[k]]);
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i, custom[1] + i, custom[2] + i };
+
+		_vs_pack_rgb_planar_c(rest, std + i * 4, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_rgb_planar_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+			    const vs_pack_desc *desc)
+{
+	const __m128i alpha = _mm_set1_epi8(-1);
+	__m128i c[3], bg, ra;
+	uint32_t i, k;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		for (k = 0; k < 3; k++)
+			c[desc->order[k]] = _mm_loadu_si128((const __m128i *)(custom[k] + i));
+		bg = _mm_unpacklo_epi8(c[0], c[1]);
+		ra = _mm_unpacklo_epi8(c[2], alpha);
+		_mm_storeu_si128((__m128i *)(std + i * 4), _mm_unpacklo_epi16(bg, ra));
+		_mm_storeu_si128((__m128i *)(std + i * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+		bg = _mm_unpackhi_epi8(c[0], c[1]);
+		ra = _mm_unpackhi_epi8(c[2], alpha);
+		_mm_storeu_si128((__m128i *)(std + i * 4 + 32), _mm_unpacklo_epi16(bg, ra));
+		_mm_storeu_si128((__m128i *)(std + i * 4 + 48), _mm_unpackhi_epi16(bg, ra));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i, custom[1] + i, custom[2] + i };
+
+		_vs_unpack_rgb_planar_c(std + i * 4, rest, n - i, desc);
+	}
+}
+
+/* 4 pixels into 12 bytes */
+__attribute__((target("ssse3"))) static void
+_vs_pack_565a8_ssse3(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+		     const vs_pack_desc *desc)
+{
+	const __m128i compact = VS_SHUF(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	const __m128i mask5 = _mm_set1_epi32(0x1f), mask6 = _mm_set1_epi32(0x3f);
+	uint8_t *dst = custom[0];
+	__m128i px, v, b, g, r;
+	uint32_t i;
+
+	for (i = 0; i + 4 <= n; i += 4, dst += 12) {
+		px = _mm_loadu_si128((const __m128i *)(std + i * 4));
+		b = _mm_and_si128(_mm_srli_epi32(px, 3), mask5);
+		g = _mm_and_si128(_mm_srli_epi32(px, 10), mask6);
+		r = _mm_and_si128(_mm_srli_epi32(px, 19), mask5);
+		if (desc->swap)
+			v = _mm_or_si128(_mm_slli_epi32(b, 11), r);
+		else
+			v = _mm_or_si128(_mm_slli_epi32(r, 11), b);
+		/* alpha from byte 3 of the pixel to byte 2, next to the 16 bits */
+		v = _mm_or_si128(v, _mm_slli_epi32(g, 5));
+		v = _mm_or_si128(v, _mm_slli_epi32(_mm_srli_epi32(px, 24), 16));
+		v = _mm_shuffle_epi8(v, compact);
+		_mm_storel_epi64((__m128i *)dst, v);
+		_vs_store32(dst + 8, _mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { dst };
+
+		_vs_pack_565a8_c(rest, std + i * 4, n - i, desc);
+	}
+}
+
+__attribute__((target("ssse3"))) static void
+_vs_unpack_565a8_ssse3(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+		       const vs_pack_desc *desc)
+{
+	const __m128i spread = VS_SHUF(0, 1, -1, 2, 3, 4, -1, 5, 6, 7, -1, 8, 9, 10, -1, 11);
+	const __m128i mask5 = _mm_set1_epi32(0x1f), mask6 = _mm_set1_epi32(0x3f);
+	const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+	const uint8_t *src = custom[0];
+	__m128i v, hi, g, lo;
+	uint32_t i;
+
+	for (i = 0; i + 4 <= n; i += 4, src += 12) {
+		v = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src),
+				       _mm_cvtsi32_si128(_vs_load32(src + 8)));
+		/* the 16 bits in the low half of each pixel, alpha in byte 3 */
+		v = _mm_shuffle_epi8(v, spread);
+		hi = _mm_and_si128(_mm_srli_epi32(v, 11), mask5);
+		g = _mm_and_si128(_mm_srli_epi32(v, 5), mask6);
+		lo = _mm_and_si128(v, mask5);
+		hi = _mm_or_si128(_mm_slli_epi32(hi, 3), _mm_srli_epi32(hi, 2));
+		g = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+		lo = _mm_or_si128(_mm_slli_epi32(lo, 3), _mm_srli_epi32(lo, 2));
+		if (desc->swap)
+			v = _mm_or_si128(_mm_and_si128(v, alpha),
+					 _mm_or_si128(hi, _mm_slli_epi32(lo, 16)));
+		else
+			v = _mm_or_si128(_mm_and_si128(v, alpha),
+					 _mm_or_si128(lo, _mm_slli_epi32(hi, 16)));
+		_mm_storeu_si128((__m128i *)(std + i * 4), _mm_or_si128(v, _mm_slli_epi32(g, 8)));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { src };
+
+		_vs_unpack_565a8_c(std + i * 4, rest, n - i, desc);
+	}
+}
+#elif defined(VS_PACK_NEON)
+/* 8 samples of 10 bits in 16 bits into 10 bytes */
+static inline void _vs_pack_10bit_8x_neon(uint8_t *dst, uint16x8_t v)
+{
+	uint32x4_t w = vreinterpretq_u32_u16(v);
+	uint64x2_t q;
+
+	/* s0 | s1 << 10 in 32 bits, then four samples in 40 of 64 bits */
+	w = vorrq_u32(vandq_u32(w, vdupq_n_u32(0x3ff)), vshlq_n_u32(vshrq_n_u32(w, 16), 10));
+	q = vreinterpretq_u64_u32(w);
+	q = vorrq_u64(vandq_u64(q, vdupq_n_u64(0xfffff)), vshlq_n_u64(vshrq_n_u64(q, 32), 20));
+	_vs_store64(dst, vgetq_lane_u64(q, 0) | vgetq_lane_u64(q, 1) << 40);
+	_vs_store16(dst + 8, vgetq_lane_u64(q, 1) >> 24);
+}
+
+static inline uint16x8_t _vs_unpack_10bit_8x_neon(const uint8_t *src)
+{
+	uint64_t x = _vs_load64(src);
+	uint64x2_t q = vcombine_u64(vcreate_u64(x & 0xffffffffffULL),
+				    vcreate_u64(x >> 40 | (uint64_t)_vs_load16(src + 8) << 24));
+	uint32x4_t w;
+
+	/* four samples in 40 of 64 bits, then two in 32, then one in 16 */
+	q = vorrq_u64(vandq_u64(q, vdupq_n_u64(0xfffff)), vshlq_n_u64(vshrq_n_u64(q, 20), 32));
+	w = vreinterpretq_u32_u64(q);
+	w = vorrq_u32(vandq_u32(w, vdupq_n_u32(0x3ff)), vshlq_n_u32(vshrq_n_u32(w, 10), 16));
+	return vreinterpretq_u16_u32(w);
+}
+
+static void _vs_pack_10bit_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				const vs_pack_desc *desc)
+{
+	uint8_t *dst = custom[0];
+	uint16x8_t v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, dst += 10) {
+		v = vreinterpretq_u16_u8(vld1q_u8(std + i * 2));
+		_vs_pack_10bit_8x_neon(dst, vshrq_n_u16(v, 6));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { dst };
+
+		_vs_pack_10bit_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+static void _vs_unpack_10bit_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				  const vs_pack_desc *desc)
+{
+	const uint8_t *src = custom[0];
+	uint16x8_t v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, src += 10) {
+		v = vshlq_n_u16(_vs_unpack_10bit_8x_neon(src), 6);
+		vst1q_u8(std + i * 2, vreinterpretq_u8_u16(v));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { src };
+
+		_vs_unpack_10bit_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+static void _vs_pack_10bit8_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				 const vs_pack_desc *desc)
+{
+	uint8_t *dst = custom[0];
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, dst += 10)
+		_vs_pack_10bit_8x_neon(dst, vshll_n_u8(vld1_u8(std + i), 2));
+
+	if (i < n) {
+		uint8_t *rest[3] = { dst };
+
+		_vs_pack_10bit8_c(rest, std + i, n - i, desc);
+	}
+}
+
+static void _vs_unpack_10bit8_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				   const vs_pack_desc *desc)
+{
+	const uint8_t *src = custom[0];
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8, src += 10)
+		vst1_u8(std + i, vshrn_n_u16(_vs_unpack_10bit_8x_neon(src), 2));
+
+	if (i < n) {
+		const uint8_t *rest[3] = { src };
+
+		_vs_unpack_10bit8_c(std + i, rest, n - i, desc);
+	}
+}
+
+/* four words of three 10 bit samples */
+static inline uint32x4_t _vs_3in32_neon(uint16x4_t a, uint16x4_t b, uint16x4_t c)
+{
+	return vorrq_u32(vmovl_u16(a),
+			 vorrq_u32(vshll_n_u16(b, 10), vshlq_n_u32(vmovl_u16(c), 20)));
+}
+
+/* 24 samples into 8 words */
+static void _vs_pack_3in32_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				const vs_pack_desc *desc)
+{
+	uint16x8_t a, b, c;
+	uint32x4_t lo, hi;
+	uint16x8x3_t s;
+	uint8_t *dst;
+	uint32_t i;
+
+	for (i = 0; i + 24 <= n; i += 24) {
+		dst = custom[0] + i / 3 * 4;
+		s = vld3q_u16((const uint16_t *)(std + i * 2));
+		a = vshrq_n_u16(s.val[0], 6);
+		b = vshrq_n_u16(s.val[1], 6);
+		c = vshrq_n_u16(s.val[2], 6);
+		lo = _vs_3in32_neon(vget_low_u16(a), vget_low_u16(b), vget_low_u16(c));
+		hi = _vs_3in32_neon(vget_high_u16(a), vget_high_u16(b), vget_high_u16(c));
+		vst1q_u8(dst, vreinterpretq_u8_u32(lo));
+		vst1q_u8(dst + 16, vreinterpretq_u8_u32(hi));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i / 3 * 4 };
+
+		_vs_pack_3in32_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+static void _vs_unpack_3in32_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				  const vs_pack_desc *desc)
+{
+	const uint32x4_t low10 = vdupq_n_u32(0x3ff);
+	uint32x4_t w0, w1;
+	uint16x8x3_t s;
+	uint16x8_t v;
+	uint32_t i, k;
+
+	for (i = 0; i + 24 <= n; i += 24) {
+		w0 = vreinterpretq_u32_u8(vld1q_u8(custom[0] + i / 3 * 4));
+		w1 = vreinterpretq_u32_u8(vld1q_u8(custom[0] + i / 3 * 4 + 16));
+		for (k = 0; k < 3; k++) {
+			v = vcombine_u16(vmovn_u32(vandq_u32(w0, low10)),
+					 vmovn_u32(vandq_u32(w1, low10)));
+			s.val[k] = vshlq_n_u16(v, 6);
+			w0 = vshrq_n_u32(w0, 10);
+			w1 = vshrq_n_u32(w1, 10);
+		}
+		vst3q_u16((uint16_t *)(std + i * 2), s);
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i / 3 * 4 };
+
+		_vs_unpack_3in32_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+static void _vs_pack_luma10_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				 const vs_pack_desc *desc)
+{
+	uint16x8_t v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		v = vreinterpretq_u16_u8(vld1q_u8(std + i * 2));
+		vst1q_u8(custom[0] + i * 2, vreinterpretq_u8_u16(vshrq_n_u16(v, 6)));
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i * 2 };
+
+		_vs_pack_luma10_c(rest, std + i * 2, n - i, desc);
+	}
+}
+
+static void _vs_unpack_luma10_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				   const vs_pack_desc *desc)
+{
+	const uint16x8_t low10 = vdupq_n_u16(0x3ff);
+	uint16x8_t v;
+	uint32_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		v = vandq_u16(vreinterpretq_u16_u8(vld1q_u8(custom[0] + i * 2)), low10);
+		vst1q_u8(std + i * 2, vreinterpretq_u8_u16(vshlq_n_u16(v, 6)));
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i * 2 };
+
+		_vs_unpack_luma10_c(std + i * 2, rest, n - i, desc);
+	}
+}
+
+/* 16 pixels into 16 bytes of each plane */
+static void _vs_pack_rgb_planar_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				     const vs_pack_desc *desc)
+{
+	uint8x16x4_t px;
+	uint32_t i, k;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		px = vld4q_u8(std + i * 4);
+		for (k = 0; k < 3; k++)
+			vst1q_u8(custom[k] + i, px.val[desc->order[k]]);
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i, custom[1] + i, custom[2] + i };
+
+		_vs_pack_rgb_planar_c(rest, std + i * 4, n - i, desc);
+	}
+}
+
+static void _vs_unpack_rgb_planar_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				       const vs_pack_desc *desc)
+{
+	uint8x16x4_t px;
+	uint32_t i, k;
+
+	px.val[3] = vdupq_n_u8(0xff);
+	for (i = 0; i + 16 <= n; i += 16) {
+		for (k = 0; k < 3; k++)
+			px.val[desc->order[k]] = vld1q_u8(custom[k] + i);
+		vst4q_u8(std + i * 4, px);
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i, custom[1] + i, custom[2] + i };
+
+		_vs_unpack_rgb_planar_c(std + i * 4, rest, n - i, desc);
+	}
+}
+
+/* 16 pixels into 48 bytes, the two bytes of the 565 built without widening */
+static void _vs_pack_565a8_neon(uint8_t *const custom[3], const uint8_t *std, uint32_t n,
+				const vs_pack_desc *desc)
+{
+	uint8x16_t hi, g, lo;
+	uint8x16x4_t px;
+	uint8x16x3_t out;
+	uint32_t i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		px = vld4q_u8(std + i * 4);
+		hi = vshrq_n_u8(px.val[desc->swap ? 0 : 2], 3);
+		g = vshrq_n_u8(px.val[1], 2);
+		lo = vshrq_n_u8(px.val[desc->swap ? 2 : 0], 3);
+		out.val[0] = vorrq_u8(vshlq_n_u8(g, 5), lo);
+		out.val[1] = vorrq_u8(vshlq_n_u8(hi, 3), vshrq_n_u8(g, 3));
+		out.val[2] = px.val[3];
+		vst3q_u8(custom[0] + i * 3, out);
+	}
+
+	if (i < n) {
+		uint8_t *rest[3] = { custom[0] + i * 3 };
+
+		_vs_pack_565a8_c(rest, std + i * 4, n - i, desc);
+	}
+}
+
+static void _vs_unpack_565a8_neon(uint8_t *std, const uint8_t *const custom[3], uint32_t n,
+				  const vs_pack_desc *desc)
+{
+	const uint8x16_t mask3 = vdupq_n_u8(0x7), mask5 = vdupq_n_u8(0x1f);
+	uint8x16_t hi, g, lo;
+	uint8x16x3_t in;
+	uint8x16x4_t px;
+	uint32_t i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		in = vld3q_u8(custom[0] + i * 3);
+		hi = vshrq_n_u8(in.val[1], 3);
+		g = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], mask3), 3), vshrq_n_u8(in.val[0], 5));
+		lo = vandq_u8(in.val[0], mask5);
+		px.val[desc->swap ? 0 : 2] = vorrq_u8(vshlq_n_u8(hi, 3), vshrq_n_u8(hi, 2));
+		px.val[1] = vorrq_u8(vshlq_n_u8(g, 2), vshrq_n_u8(g, 4));
+		px.val[desc->swap ? 2 : 0] = vorrq_u8(vshlq_n_u8(lo, 3), vshrq_n_u8(lo, 2));
+		px.val[3] = in.val[2];
+		vst4q_u8(std + i * 4, px);
+	}
+
+	if (i < n) {
+		const uint8_t *rest[3] = { custom[0] + i * 3 };
+
+		_vs_unpack_565a8_c(std + i * 4, rest, n - i, desc);
+	}
+}
+#endif
+
+static vs_pack_row_fn vs_pack_rows[VS_PACK_KIND_COUNT] = {
+	[VS_PACK_10BIT] = _vs_pack_10bit_c,
+	[VS_PACK_10BIT8] = _vs_pack_10bit8_c,
+	[VS_PACK_3IN32] = _vs_pack_3in32_c,
+	[VS_PACK_LUMA10] = _vs_pack_luma10_c,
+	[VS_PACK_RGB_PLANAR] = _vs_pack_rgb_planar_c,
+	[VS_PACK_565A8] = _vs_pack_565a8_c,
+};
+static vs_unpack_row_fn vs_unpack_rows[VS_PACK_KIND_COUNT] = {
+	[VS_PACK_10BIT] = _vs_unpack_10bit_c,
+	[VS_PACK_10BIT8] = _vs_unpack_10bit8_c,
+	[VS_PACK_3IN32] = _vs_unpack_3in32_c,
+	[VS_PACK_LUMA10] = _vs_unpack_luma10_c,
+	[VS_PACK_RGB_PLANAR] = _vs_unpack_rgb_planar_c,
+	[VS_PACK_565A8] = _vs_unpack_565a8_c,
+};
+static const char *vs_pack_isa_name = "c";
+
+__attribute__((constructor)) static void _vs_pack_init(void)
+{
+#ifdef VS_PACK_X86
+	__builtin_cpu_init();
+	if (!__builtin_cpu_supports("ssse3"))
+		return;
+
+	vs_pack_rows[VS_PACK_10BIT] = _vs_pack_10bit_ssse3;
+	vs_pack_rows[VS_PACK_10BIT8] = _vs_pack_10bit8_ssse3;
+	vs_pack_rows[VS_PACK_3IN32] = _vs_pack_3in32_ssse3;
+	vs_pack_rows[VS_PACK_LUMA10] = _vs_pack_luma10_ssse3;
+	vs_pack_rows[VS_PACK_RGB_PLANAR] = _vs_pack_rgb_planar_ssse3;
+	vs_pack_rows[VS_PACK_565A8] = _vs_pack_565a8_ssse3;
+	vs_unpack_rows[VS_PACK_10BIT] = _vs_unpack_10bit_ssse3;
+	vs_unpack_rows[VS_PACK_10BIT8] = _vs_unpack_10bit8_ssse3;
+	vs_unpack_rows[VS_PACK_3IN32] = _vs_unpack_3in32_ssse3;
+	vs_unpack_rows[VS_PACK_LUMA10] = _vs_unpack_luma10_ssse3;
+	vs_unpack_rows[VS_PACK_RGB_PLANAR] = _vs_unpack_rgb_planar_ssse3;
+	vs_unpack_rows[VS_PACK_565A8] = _vs_unpack_565a8_ssse3;
+	vs_pack_isa_name = "ssse3";
+#elif defined(VS_PACK_NEON)
+	vs_pack_rows[VS_PACK_10BIT] = _vs_pack_10bit_neon;
+	vs_pack_rows[VS_PACK_10BIT8] = _vs_pack_10bit8_neon;
+	vs_pack_rows[VS_PACK_3IN32] = _vs_pack_3in32_neon;
+	vs_pack_rows[VS_PACK_LUMA10] = _vs_pack_luma10_neon;
+	vs_pack_rows[VS_PACK_RGB_PLANAR] = _vs_pack_rgb_planar_neon;
+	vs_pack_rows[VS_PACK_565A8] = _vs_pack_565a8_neon;
+	vs_unpack_rows[VS_PACK_10BIT] = _vs_unpack_10bit_neon;
+	vs_unpack_rows[VS_PACK_10BIT8] = _vs_unpack_10bit8_neon;
+	vs_unpack_rows[VS_PACK_3IN32] = _vs_unpack_3in32_neon;
+	vs_unpack_rows[VS_PACK_LUMA10] = _vs_unpack_luma10_neon;
+	vs_unpack_rows[VS_PACK_RGB_PLANAR] = _vs_unpack_rgb_planar_neon;
+	vs_unpack_rows[VS_PACK_565A8] = _vs_unpack_565a8_neon;
+	vs_pack_isa_name = "neon";
+#endif
+}
+
+const char *drm_vs_pack_isa(void)
+{
+	return vs_pack_isa_name;
+}
+
+/* @source 0 picks the default source of @format */
+static const vs_pack_desc *_vs_get_pack_desc(uint32_t format, uint32_t source)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(vs_pack_tab) / sizeof(vs_pack_tab[0]); i++)
+		if (vs_pack_tab[i].format == format && (!source || vs_pack_tab[i].source == source))
+			return &vs_pack_tab[i];
+
+	return NULL;
+}
+
+uint32_t drm_vs_get_custom_source(uint32_t format)
+{
+	const vs_pack_desc *desc = _vs_get_pack_desc(format, 0);
+
+	return desc ? desc->source : 0;
+}
+
+/* samples, or pixels for the RGB kinds, held by @bytes of a custom row */
+static uint32_t _vs_pack_row_count(vs_pack_kind kind, uint64_t bytes)
+{
+	switch (kind) {
+	case VS_PACK_10BIT:
+	case VS_PACK_10BIT8:
+		return bytes * 8 / 10;
+	case VS_PACK_3IN32:
+		return bytes / 4 * 3;
+	case VS_PACK_LUMA10:
+		return bytes / 2;
+	case VS_PACK_565A8:
+		return bytes / 3;
+	default:
+		return bytes;
+	}
+}
+
+/*
+ * Walk the rows of each custom plane with the standard plane they come from,
+ * packing if @pack, else unpacking. The three planes of planar RGB are
+ * walked together from the single XRGB8888 plane.
+ */
+static int _vs_pack_planes(const vs_pack_desc *pack_desc, uint32_t width, uint32_t height,
+			   uint8_t *const std[4], const uint32_t std_pitches[4],
+			   uint8_t *const custom[4], const uint32_t custom_pitches[4], bool pack)
+{
+	bool planar = pack_desc->kind == VS_PACK_RGB_PLANAR;
+	drm_vs_format_desc desc;
+	uint32_t i, k, p, y, n[4], rows, std_cpp, planes;
+	uint8_t *row[3];
+	uint64_t bytes;
+
+	if (!std_pitches || !custom_pitches ||
+	    drm_vs_get_format_desc(pack_desc->format, DRM_FORMAT_MOD_VS_CUSTOM_FORMAT, &desc))
+		return -EINVAL;
+
+	switch (pack_desc->source) {
+	case DRM_FORMAT_NV12:
+		std_cpp = 1;
+		break;
+	case DRM_FORMAT_P010:
+		std_cpp = 2;
+		break;
+	default:
+		std_cpp = 4;
+		break;
+	}
+	planes = planar ? 1 : desc.num_planes;
+
+	for (i = 0; i < desc.num_planes; i++) {
+		bytes = (uint64_t)(width / desc.hsub[i]) * desc.bpp[i] / 8;
+		if (!custom[i] || custom_pitches[i] < bytes)
+			return -EINVAL;
+		n[i] = _vs_pack_row_count(pack_desc->kind, bytes);
+		if (i < planes && (!std[i] || std_pitches[i] < (uint64_t)n[i] * std_cpp))
+			return -EINVAL;
+	}
+
+	for (i = 0; i < planes; i++) {
+		rows = height / desc.vsub[i];
+		for (y = 0; y < rows; y++) {
+			for (k = 0; k < 3; k++) {
+				p = planar ? k : i;
+				row[k] = custom[p] + (uint64_t)custom_pitches[p] * y;
+			}
+			if (pack)
+				vs_pack_rows[pack_desc->kind](
+					row, std[i] + (uint64_t)std_pitches[i] * y, n[i], pack_desc);
+			else
+				vs_unpack_rows[pack_desc->kind](std[i] + (uint64_t)std_pitches[i] * y,
+								(const uint8_t *const *)row, n[i],
+								pack_desc);
+		}
+	}
+
+	return 0;
+}
+
+int drm_vs_pack_custom_ext(uint32_t format, uint32_t source, uint32_t width, uint32_t height,
+			   const void *const src[4], const uint32_t src_pitches[4],
+			   void *const dst[4], const uint32_t dst_pitches[4])
+{
+	const vs_pack_desc *desc = _vs_get_pack_desc(format, source);
+	uint8_t *std[4], *custom[4];
+	uint32_t i;
+
+	if (!desc || !src || !dst)
+		return -EINVAL;
+
+	for (i = 0; i < 4; i++) {
+		std[i] = (uint8_t *)src[i];
+		custom[i] = dst[i];
+	}
+
+	return _vs_pack_planes(desc, width, height, std, src_pitches, custom, dst_pitches, true);
+}
+
+int drm_vs_pack_custom(uint32_t format, uint32_t width, uint32_t height, const void *const src[4],
+		       const uint32_t src_pitches[4], void *const dst[4],
+		       const uint32_t dst_pitches[4])
+{
+	return drm_vs_pack_custom_ext(format, 0, width, height, src, src_pitches, dst, dst_pitches);
+}
+
+int drm_vs_unpack_custom_ext(uint32_t format, uint32_t source, uint32_t width, uint32_t height,
+			     const void *const src[4], const uint32_t src_pitches[4],
+			     void *const dst[4], const uint32_t dst_pitches[4])
+{
+	const vs_pack_desc *desc = _vs_get_pack_desc(format, source);
+	uint8_t *std[4], *custom[4];
+	uint32_t i;
+
+	if (!desc || !src || !dst)
+		return -EINVAL;
+
+	for (i = 0; i < 4; i++) {
+		std[i] = dst[i];
+		custom[i] = (uint8_t *)src[i];
+	}
+
+	return _vs_pack_planes(desc, width, height, std, dst_pitches, custom, src_pitches, false);
+}
+
+int drm_vs_unpack_custom(uint32_t format, uint32_t width, uint32_t height,
+			 const void *const src[4], const uint32_t src_pitches[4],
+			 void *const dst[4], const uint32_t dst_pitches[4])
+{
+	return drm_vs_unpack_custom_ext(format, 0, width, height, src, src_pitches, dst,
+					dst_pitches);
+}
@@ -0,0 +1,353 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <drm/vs_drm.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+
+#include "vs_bo_helper.h"
+#include "vs_bo_pool.h"
+
+/* smallest size class, one page */
+#define VS_POOL_MIN_CLASS_SHIFT 12
+/* size classes per power of two */
+#define VS_POOL_CLASS_STEPS_SHIFT 2
+#define VS_POOL_CLASS_COUNT (((64 - VS_POOL_MIN_CLASS_SHIFT) << VS_POOL_CLASS_STEPS_SHIFT) + 1)
+
+typedef struct _vs_pool_node {
+	struct _vs_pool_node *next;
+	uint32_t handle;
+	uint64_t size;
+} vs_pool_node;
+
+struct drm_vs_bo_pool {
+	drm_vs_bo_backend backend;
+	uint64_t max_cached;
+
+	/* protects everything below, held for list and counter updates only */
+	atomic_flag lock;
+	/* free buffers of each size class */
+	vs_pool_node *free_list[VS_POOL_CLASS_COUNT];
+	/* nodes not holding any buffer, so that a steady state does not malloc */
+	vs_pool_node *spare;
+	drm_vs_bo_pool_stats stats;
+};
+
+static int _vs_drm_create(void *priv, uint32_t width, uint32_t height, uint32_t bpp,
+			  uint32_t *handle, uint64_t *size)
+{
+	struct drm_mode_create_dumb create;
+
+	memset(&create, 0, sizeof(create));
+	create.width = width;
+	create.height = height;
+	create.bpp = bpp;
+
+	if (ioctl((int)(intptr_t)priv, DRM_IOCTL_MODE_CREATE_DUMB, &create) < 0)
+		return -errno;
+
+	*handle = create.handle;
+	*size = create.size;
+
+	return 0;
+}
+
+static void _vs_drm_destroy(void *priv, uint32_t handle)
+{
+	struct drm_mode_destroy_dumb destroy;
+
+	memset(&destroy, 0, sizeof(destroy));
+	destroy.handle = handle;
+
+	ioctl((int)(intptr_t)priv, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+}
+
+static int _vs_drm_add_fb(void *priv, struct drm_mode_fb_cmd2 *fb)
+{
+	if (ioctl((int)(intptr_t)priv, DRM_IOCTL_MODE_ADDFB2, fb) < 0)
+		return -errno;
+
+	return 0;
+}
+
+static void _vs_drm_rm_fb(void *priv, uint32_t fb_id)
+{
+	ioctl((int)(intptr_t)priv, DRM_IOCTL_MODE_RMFB, &fb_id);
+}
+
+void drm_vs_bo_backend_init_drm(drm_vs_bo_backend *backend, int fd)
+{
+	backend->create = _vs_drm_create;
+	backend->destroy = _vs_drm_destroy;
+	backend->add_fb = _vs_drm_add_fb;
+	backend->rm_fb = _vs_drm_rm_fb;
+	backend->priv = (void *)(intptr_t)fd;
+}
+
+static inline void _vs_pool_lock(drm_vs_bo_pool *pool)
+{
+	while (atomic_flag_test_and_set_explicit(&pool->lock, memory_order_acquire))
+		;
+}
+
+static inline void _vs_pool_unlock(drm_vs_bo_pool *pool)
+{
+	atomic_flag_clear_explicit(&pool->lock, memory_order_release);
+}
+
+static inline uint32_t _vs_pool_log2(uint64_t val)
+{
+	return 63 - __builtin_clzll(val);
+}
+
+uint64_t drm_vs_bo_pool_size_class(uint64_t size)
+{
+	uint32_t shift;
+
+	if (size <= 1ull << VS_POOL_MIN_CLASS_SHIFT)
+		return 1ull << VS_POOL_MIN_CLASS_SHIFT;
+
+	/* keep the VS_POOL_CLASS_STEPS_SHIFT bits below the leading one */
+	shift = _vs_pool_log2(size - 1) - VS_POOL_CLASS_STEPS_SHIFT;
+
+	return (((size - 1) >> shift) + 1) << shift;
+}
+
+/* index in free_list of a size class, 0 for the smallest one */
+static uint32_t _vs_pool_class_index(uint64_t class_size)
+{
+	uint32_t log2, step;
+
+	if (class_size <= 1ull << VS_POOL_MIN_CLASS_SHIFT)
+		return 0;
+
+	log2 = _vs_pool_log2(class_size - 1);
+	step = ((class_size - 1) >> (log2 - VS_POOL_CLASS_STEPS_SHIFT)) &
+	       ((1 << VS_POOL_CLASS_STEPS_SHIFT) - 1);
+
+	return ((log2 - VS_POOL_MIN_CLASS_SHIFT) << VS_POOL_CLASS_STEPS_SHIFT) + step + 1;
+}
+
+/* index of the largest size class a buffer of @size bytes can serve, -1 if none */
+static int _vs_pool_fit_index(uint64_t size)
+{
+	uint64_t class_size = drm_vs_bo_pool_size_class(size);
+	uint32_t index = _vs_pool_class_index(class_size);
+
+	if (class_size == size)
+		return index;
+
+	return (int)index - 1;
+}
+
+drm_vs_bo_pool *drm_vs_bo_pool_create(const drm_vs_bo_backend *backend, uint64_t max_cached)
+{
+	drm_vs_bo_pool *pool;
+
+	if (!backend || !backend->create || !backend->destroy)
+		return NULL;
+
+	pool = calloc(1, sizeof(*pool));
+	if (!pool)
+		return NULL;
+
+	pool->backend = *backend;
+	pool->max_cached = max_cached;
+	atomic_flag_clear(&pool->lock);
+
+	return pool;
+}
+
+/* unlink all free buffers and spare nodes, called with the lock held */
+static vs_pool_node *_vs_pool_take_all(drm_vs_bo_pool *pool)
+{
+	vs_pool_node *head = pool->spare, *node;
+	uint32_t i;
+
+	pool->spare = NULL;
+	for (i = 0; i < VS_POOL_CLASS_COUNT; i++) {
+		while ((node = pool->free_list[i])) {
+			pool->free_list[i] = node->next;
+			node->next = head;
+			head = node;
+			pool->stats.destroys++;
+		}
+	}
+	pool->stats.cached_bos = 0;
+	pool->stats.cached_bytes = 0;
+
+	return head;
+}
+
+static void _vs_pool_release(drm_vs_bo_pool *pool, vs_pool_node *head)
+{
+	vs_pool_node *node;
+
+	while ((node = head)) {
+		head = node->next;
+		if (node->size)
+			pool->backend.destroy(pool->backend.priv, node->handle);
+		free(node);
+	}
+}
+
+void drm_vs_bo_pool_destroy(drm_vs_bo_pool *pool)
+{
+	if (!pool)
+		return;
+
+	_vs_pool_release(pool, _vs_pool_take_all(pool));
+	free(pool);
+}
+
+void drm_vs_bo_pool_trim(drm_vs_bo_pool *pool)
+{
+	vs_pool_node *head;
+
+	_vs_pool_lock(pool);
+	head = _vs_pool_take_all(pool);
+	_vs_pool_unlock(pool);
+
+	_vs_pool_release(pool, head);
+}
+
+int drm_vs_bo_pool_alloc(drm_vs_bo_pool *pool, uint32_t width, uint32_t height, uint32_t format,
+			 uint64_t mod, drm_vs_pool_bo *bo)
+{
+	uint64_t class_size, rows;
+	vs_pool_node *node;
+	uint32_t index, pitch;
+	int ret;
+
+	if (!pool || !bo)
+		return -EINVAL;
+
+	memset(bo, 0, sizeof(*bo));
+
+	drm_vs_get_align_size(&width, &height, format, mod);
+	ret = drm_vs_get_bo_layout(width, height, format, mod, &bo->layout);
+	if (ret)
+		return ret;
+
+	if (!bo->layout.dumb.width)
+		return -EINVAL;
+
+	class_size = drm_vs_bo_pool_size_class(bo->layout.size);
+	index = _vs_pool_class_index(class_size);
+
+	_vs_pool_lock(pool);
+	node = pool->free_list[index];
+	if (node) {
+		pool->free_list[index] = node->next;
+		pool->stats.cached_bos--;
+		pool->stats.cached_bytes -= node->size;
+		pool->stats.allocs++;
+		pool->stats.reuses++;
+
+		bo->handle = node->handle;
+		bo->size = node->size;
+
+		/* keep the node for the next free */
+		node->size = 0;
+		node->next = pool->spare;
+		pool->spare = node;
+	}
+	_vs_pool_unlock(pool);
+
+	if (node)
+		return 0;
+
+	/* a new buffer covers the whole class, so it can serve any layout of it */
+	pitch = bo->layout.dumb.width;
+	rows = (class_size + pitch - 1) / pitch;
+	if (rows > UINT32_MAX / pitch)
+		rows = bo->layout.dumb.height;
+
+	ret = pool->backend.create(pool->backend.priv, pitch, rows, bo->layout.dumb.bpp,
+				   &bo->handle, &bo->size);
+	if (ret)
+		return ret;
+
+	_vs_pool_lock(pool);
+	pool->stats.allocs++;
+	pool->stats.creates++;
+	_vs_pool_unlock(pool);
+
+	return 0;
+}
+
+void drm_vs_bo_pool_free(drm_vs_bo_pool *pool, const drm_vs_pool_bo *bo)
+{
+	vs_pool_node *node;
+	int index;
+
+	if (!pool || !bo || !bo->size)
+		return;
+
+	index = _vs_pool_fit_index(bo->size);
+
+	_vs_pool_lock(pool);
+	node = pool->spare;
+	if (node)
+		pool->spare = node->next;
+	_vs_pool_unlock(pool);
+
+	if (!node)
+		node = malloc(sizeof(*node));
+
+	_vs_pool_lock(pool);
+	if (node && index >= 0 && pool->stats.cached_bytes + bo->size <= pool->max_cached) {
+		node->handle = bo->handle;
+		node->size = bo->size;
+		node->next = pool->free_list[index];
+		pool->free_list[index] = node;
+		pool->stats.cached_bos++;
+		pool->stats.cached_bytes += bo->size;
+		_vs_pool_unlock(pool);
+		return;
+	}
+
+	if (node) {
+		node->size = 0;
+		node->next = pool->spare;
+		pool->spare = node;
+	}
+	pool->stats.destroys++;
+	_vs_pool_unlock(pool);
+
+	pool->backend.destroy(pool->backend.priv, bo->handle);
+}
+
+void drm_vs_bo_pool_get_stats(drm_vs_bo_pool *pool, drm_vs_bo_pool_stats *stats)
+{
+	_vs_pool_lock(pool);
+	*stats = pool->stats;
+	_vs_pool_unlock(pool);
+}
@@ -0,0 +1,492 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VS_SWIZZLE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VS_SWIZZLE_NEON 1
+#endif
+
+#include "vs_bo_helper.h"
+#include "vs_bo_inline.h"
+#include "vs_bo_swizzle.h"
+
+/* tiles of one plane */
+typedef struct _vs_swizzle_tile {
+	uint32_t cpp;
+	/* width and height divisor, and size in pixels of the plane */
+	uint32_t hsub;
+	uint32_t vsub;
+	uint32_t plane_w;
+	uint32_t plane_h;
+	/* (super) tile and inner tile size in pixels */
+	uint32_t tile_w;
+	uint32_t tile_h;
+	uint32_t inner_w;
+	uint32_t inner_h;
+	bool y_major;
+	/* bytes of one inner tile line, one inner tile and one (super) tile */
+	uint32_t span;
+	uint32_t inner_bytes;
+	uint64_t tile_stride;
+	/* bytes between two inner tiles side by side */
+	uint64_t inner_stride;
+} vs_swizzle_tile;
+
+typedef void (*vs_swizzle_row_fn)(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile);
+typedef void (*vs_detile_row_fn)(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile,
+				 uint32_t x, uint32_t end);
+
+/* linear @src row into the inner tile lines at @dst */
+static void _vs_swizzle_row_c(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile)
+{
+	uint32_t t, i, tiles = tile->plane_w / tile->tile_w, inner = tile->tile_w / tile->inner_w;
+
+	for (t = 0; t < tiles; t++) {
+		for (i = 0; i < inner; i++) {
+			memcpy(dst + t * tile->tile_stride + i * tile->inner_stride, src, tile->span);
+			src += tile->span;
+		}
+	}
+}
+
+/* columns @x to @end of the inner tile lines at @src into the linear @dst row */
+static void _vs_detile_row_c(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile,
+			     uint32_t x, uint32_t end)
+{
+	uint32_t n, inner = tile->tile_w / tile->inner_w, i = x % tile->tile_w / tile->inner_w;
+	uint32_t skip = x % tile->inner_w;
+
+	for (src += x / tile->tile_w * tile->tile_stride; x < end; x += n, skip = 0) {
+		n = VS_MIN(tile->inner_w - skip, end - x);
+		memcpy(dst, src + i * tile->inner_stride + skip * tile->cpp, n * tile->cpp);
+		dst += n * tile->cpp;
+		if (++i == inner) {
+			i = 0;
+			src += tile->tile_stride;
+		}
+	}
+}
+
+#ifdef VS_SWIZZLE_X86
+__attribute__((target("sse2"))) static void
+_vs_swizzle_row_sse2(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile)
+{
+	uint32_t t, i, k, tiles = tile->plane_w / tile->tile_w, inner = tile->tile_w / tile->inner_w;
+	uint8_t *d;
+
+	for (t = 0; t < tiles; t++) {
+		for (i = 0; i < inner; i++) {
+			d = dst + t * tile->tile_stride + i * tile->inner_stride;
+			for (k = 0; k + 16 <= tile->span; k += 16)
+				_mm_storeu_si128((__m128i *)(d + k),
+						 _mm_loadu_si128((const __m128i *)(src + k)));
+			if (k < tile->span)
+				memcpy(d + k, src + k, tile->span - k);
+			src += tile->span;
+		}
+	}
+}
+
+/* streaming stores when @dst is aligned, they bypass the cache on readback */
+__attribute__((target("sse2"))) static inline void _vs_stream_sse2(uint8_t *dst,
+								     const uint8_t *src,
+								     uint32_t size)
+{
+	uint32_t k = 0;
+
+	if (!((uintptr_t)dst & 15)) {
+		for (; k + 16 <= size; k += 16)
+			_mm_stream_si128((__m128i *)(dst + k),
+					 _mm_loadu_si128((const __m128i *)(src + k)));
+	}
+	for (; k + 16 <= size; k += 16)
+		_mm_storeu_si128((__m128i *)(dst + k), _mm_loadu_si128((const __m128i *)(src + k)));
+	if (k < size)
+		memcpy(dst + k, src + k, size - k);
+}
+
+__attribute__((target("sse2"))) static void
+_vs_detile_row_sse2(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile, uint32_t x,
+		    uint32_t end)
+{
+	uint32_t n, inner = tile->tile_w / tile->inner_w, i = x % tile->tile_w / tile->inner_w;
+	uint32_t skip = x % tile->inner_w;
+
+	for (src += x / tile->tile_w * tile->tile_stride; x < end; x += n, skip = 0) {
+		n = VS_MIN(tile->inner_w - skip, end - x);
+		_vs_stream_sse2(dst, src + i * tile->inner_stride + skip * tile->cpp, n * tile->cpp);
+		dst += n * tile->cpp;
+		if (++i == inner) {
+			i = 0;
+			src += tile->tile_stride;
+		}
+	}
+	_mm_sfence();
+}
+
+__attribute__((target("avx2"))) static void
+_vs_swizzle_row_avx2(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile)
+{
+	uint32_t t, i, k, tiles = tile->plane_w / tile->tile_w, inner = tile->tile_w / tile->inner_w;
+	uint8_t *d;
+
+	for (t = 0; t < tiles; t++) {
+		for (i = 0; i < inner; i++) {
+			d = dst + t * tile->tile_stride + i * tile->inner_stride;
+			for (k = 0; k + 32 <= tile->span; k += 32)
+				_mm256_storeu_si256((__m256i *)(d + k),
+						    _mm256_loadu_si256((const __m256i *)(src + k)));
+			if (k + 16 <= tile->span) {
+				_mm_storeu_si128((__m128i *)(d + k),
+						 _mm_loadu_si128((const __m128i *)(src + k)));
+				k += 16;
+			}
+			if (k < tile->span)
+				memcpy(d + k, src + k, tile->span - k);
+			src += tile->span;
+		}
+	}
+}
+
+/*
+ * streaming loads from aligned write combined mappings and streaming
+ * stores to aligned @dst
+ */
+__attribute__((target("avx2"))) static inline void _vs_stream_avx2(uint8_t *dst,
+								     const uint8_t *src,
+								     uint32_t size)
+{
+	uint32_t k = 0;
+	__m256i v;
+
+	if (!((uintptr_t)dst & 31)) {
+		for (; k + 32 <= size; k += 32) {
+			if ((uintptr_t)(src + k) & 31)
+				v = _mm256_loadu_si256((const __m256i *)(src + k));
+			else
+				v = _mm256_stream_load_si256((const __m256i *)(src + k));
+			_mm256_stream_si256((__m256i *)(dst + k), v);
+		}
+	}
+	for (; k + 32 <= size; k += 32)
+		_mm256_storeu_si256((__m256i *)(dst + k),
+				    _mm256_loadu_si256((const __m256i *)(src + k)));
+	if (k + 16 <= size) {
+		_mm_storeu_si128((__m128i *)(dst + k), _mm_loadu_si128((const __m128i *)(src + k)));
+		k += 16;
+	}
+	if (k < size)
+		memcpy(dst + k, src + k, size - k);
+}
+
+__attribute__((target("avx2"))) static void
+_vs_detile_row_avx2(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile, uint32_t x,
+		    uint32_t end)
+{
+	uint32_t n, inner = tile->tile_w / tile->inner_w, i = x % tile->tile_w / tile->inner_w;
+	uint32_t skip = x % tile->inner_w;
+
+	for (src += x / tile->tile_w * tile->tile_stride; x < end; x += n, skip = 0) {
+		n = VS_MIN(tile->inner_w - skip, end - x);
+		_vs_stream_avx2(dst, src + i * tile->inner_stride + skip * tile->cpp, n * tile->cpp);
+		dst += n * tile->cpp;
+		if (++i == inner) {
+			i = 0;
+			src += tile->tile_stride;
+		}
+	}
+	_mm_sfence();
+}
+#endif
+
+#ifdef VS_SWIZZLE_NEON
+static void _vs_swizzle_row_neon(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile)
+{
+	uint32_t t, i, k, tiles = tile->plane_w / tile->tile_w, inner = tile->tile_w / tile->inner_w;
+	uint8_t *d;
+
+	for (t = 0; t < tiles; t++) {
+		for (i = 0; i < inner; i++) {
+			d = dst + t * tile->tile_stride + i * tile->inner_stride;
+			for (k = 0; k + 16 <= tile->span; k += 16)
+				vst1q_u8(d + k, vld1q_u8(src + k));
+			if (k < tile->span)
+				memcpy(d + k, src + k, tile->span - k);
+			src += tile->span;
+		}
+	}
+}
+
+/* NEON has no streaming store intrinsic, plain 16 byte stores */
+static void _vs_detile_row_neon(uint8_t *dst, const uint8_t *src, const vs_swizzle_tile *tile,
+				uint32_t x, uint32_t end)
+{
+	const uint8_t *s;
+	uint32_t n, k, size, inner = tile->tile_w / tile->inner_w;
+	uint32_t i = x % tile->tile_w / tile->inner_w, skip = x % tile->inner_w;
+
+	for (src += x / tile->tile_w * tile->tile_stride; x < end; x += n, skip = 0) {
+		n = VS_MIN(tile->inner_w - skip, end - x);
+		s = src + i * tile->inner_stride + skip * tile->cpp;
+		size = n * tile->cpp;
+		for (k = 0; k + 16 <= size; k += 16)
+			vst1q_u8(dst + k, vld1q_u8(s + k));
+		if (k < size)
+			memcpy(dst + k, s + k, size - k);
+		dst += size;
+		if (++i == inner) {
+			i = 0;
+			src += tile->tile_stride;
+		}
+	}
+}
+#endif
+
+static vs_swizzle_row_fn vs_swizzle_row_to_tiled = _vs_swizzle_row_c;
+static vs_detile_row_fn vs_detile_row_to_linear = _vs_detile_row_c;
+static const char *vs_swizzle_isa_name = "c";
+
+__attribute__((constructor)) static void _vs_swizzle_init(void)
+{
+#ifdef VS_SWIZZLE_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		vs_swizzle_row_to_tiled = _vs_swizzle_row_avx2;
+		vs_detile_row_to_linear = _vs_detile_row_avx2;
+		vs_swizzle_isa_name = "avx2";
+	} else if (__builtin_cpu_supports("sse2")) {
+		vs_swizzle_row_to_tiled = _vs_swizzle_row_sse2;
+		vs_detile_row_to_linear = _vs_detile_row_sse2;
+		vs_swizzle_isa_name = "sse2";
+	}
+#elif defined(VS_SWIZZLE_NEON)
+	vs_swizzle_row_to_tiled = _vs_swizzle_row_neon;
+	vs_detile_row_to_linear = _vs_detile_row_neon;
+	vs_swizzle_isa_name = "neon";
+#endif
+}
+
+const char *drm_vs_swizzle_isa(void)
+{
+	return vs_swizzle_isa_name;
+}
+
+/* uncompressed tile modes whose tiles are stored whole, one after another */
+static bool _vs_swizzle_supported(uint64_t mod)
+{
+	if (fourcc_mod_vs_get_type(mod) != DRM_FORMAT_MOD_VS_TYPE_NORMAL)
+		return false;
+
+	switch (mod & DRM_FORMAT_MOD_VS_NORM_MODE_MASK) {
+	case DRM_FORMAT_MOD_VS_LINEAR:
+	case DRM_FORMAT_MOD_VS_TILE_8X8:
+	case DRM_FORMAT_MOD_VS_TILE_8X4:
+	case DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR:
+	case DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR_8X4:
+	case DRM_FORMAT_MOD_VS_SUPER_TILED_YMAJOR_4X8:
+	case DRM_FORMAT_MOD_VS_TILE_MODE4X4:
+	case DRM_FORMAT_MOD_VS_TILE_32X8:
+	case DRM_FORMAT_MOD_VS_TILE_32X8_A:
+	case DRM_FORMAT_MOD_VS_TILE_16X16:
+	case DRM_FORMAT_MOD_VS_TILE_16X4:
+	case DRM_FORMAT_MOD_VS_TILE_8X8_SUPERTILE_X:
+	case DRM_FORMAT_MOD_VS_TILE_32X8_YUVSP8X8:
+	case DRM_FORMAT_MOD_VS_TILE_16X8_YUVSP8X8:
+	case DRM_FORMAT_MOD_VS_TILE_8X8_UNIT2X2:
+	case DRM_FORMAT_MOD_VS_TILE_8X4_UNIT2X2:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* tiles of @plane, -EINVAL if it cannot be swizzled */
+static int _vs_swizzle_setup(uint32_t format, uint64_t mod, uint32_t plane, vs_swizzle_tile *tile)
+{
+	drm_vs_tile_geometry geometry;
+	drm_vs_format_desc desc;
+	uint32_t norm_mode = mod & DRM_FORMAT_MOD_VS_NORM_MODE_MASK;
+
+	if (!_vs_swizzle_supported(mod) || drm_vs_get_tile_geometry(format, mod, &geometry) ||
+	    drm_vs_get_format_desc(format, mod, &desc) || plane >= geometry.num_planes)
+		return -EINVAL;
+
+	if (!geometry.width[plane] || !geometry.height[plane] || !desc.bpp[plane] ||
+	    desc.bpp[plane] % 8)
+		return -EINVAL;
+
+	tile->cpp = desc.bpp[plane] / 8;
+	tile->hsub = desc.hsub[plane];
+	tile->vsub = desc.vsub[plane];
+	tile->tile_w = geometry.width[plane];
+	tile->tile_h = geometry.height[plane];
+	tile->inner_w = geometry.inner_width[plane];
+	tile->inner_h = geometry.inner_height[plane];
+	tile->y_major = geometry.y_major[plane];
+
+	/* 2x2 pixel units stored one after another across the tile */
+	if (norm_mode == DRM_FORMAT_MOD_VS_TILE_8X8_UNIT2X2 ||
+	    norm_mode == DRM_FORMAT_MOD_VS_TILE_8X4_UNIT2X2) {
+		tile->inner_w = 2;
+		tile->inner_h = 2;
+	}
+
+	return 0;
+}
+
+/* size the plane of @width x @height pixels, -EINVAL if it is not whole tiles */
+static int _vs_swizzle_size(uint32_t width, uint32_t height, vs_swizzle_tile *tile)
+{
+	tile->plane_w = width / tile->hsub;
+	tile->plane_h = height / tile->vsub;
+
+	/* a partial tile row would run past the end of the plane */
+	if (!tile->plane_w || tile->plane_w % tile->tile_w || tile->plane_h % tile->tile_h)
+		return -EINVAL;
+
+	/* one line high tiles follow each other, e.g. linear */
+	if (tile->tile_h == 1 && tile->inner_w == tile->tile_w) {
+		tile->tile_w = tile->plane_w;
+		tile->inner_w = tile->plane_w;
+	}
+
+	tile->span = tile->inner_w * tile->cpp;
+	tile->inner_bytes = tile->span * tile->inner_h;
+	tile->tile_stride = (uint64_t)tile->tile_w * tile->tile_h * tile->cpp;
+	tile->inner_stride = tile->y_major ?
+				     (uint64_t)tile->tile_h / tile->inner_h * tile->inner_bytes :
+				     tile->inner_bytes;
+
+	return 0;
+}
+
+/* first byte of line @y of the plane, inner tile lines as vs_swizzle_tile */
+static uint64_t _vs_swizzle_line_offset(const vs_swizzle_tile *tile, uint32_t pitch, uint32_t y)
+{
+	uint32_t line = y % tile->tile_h, iy = line / tile->inner_h;
+	uint64_t offset = (uint64_t)(y / tile->tile_h) * pitch * tile->tile_h +
+			  (uint64_t)(line % tile->inner_h) * tile->span;
+
+	/* first inner tile of the row in the (super) tile */
+	if (tile->y_major)
+		return offset + (uint64_t)iy * tile->inner_bytes;
+
+	return offset + (uint64_t)iy * (tile->tile_w / tile->inner_w) * tile->inner_bytes;
+}
+
+int drm_vs_swizzle_to_tiled(const void *src, uint32_t src_pitch, void *dst, uint32_t dst_pitch,
+			    uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			    uint32_t plane, uint32_t y, uint32_t rows)
+{
+	vs_swizzle_tile tile;
+	const uint8_t *s;
+
+	if (!src || !dst || _vs_swizzle_setup(format, mod, plane, &tile) ||
+	    _vs_swizzle_size(width, height, &tile))
+		return -EINVAL;
+
+	if (y % tile.tile_h || rows % tile.tile_h || y + rows > tile.plane_h ||
+	    (uint64_t)tile.plane_w * tile.cpp > src_pitch ||
+	    (uint64_t)tile.plane_w * tile.cpp > dst_pitch)
+		return -EINVAL;
+
+	for (s = (const uint8_t *)src + (uint64_t)y * src_pitch; rows; rows--, y++) {
+		vs_swizzle_row_to_tiled((uint8_t *)dst + _vs_swizzle_line_offset(&tile, dst_pitch, y),
+					s, &tile);
+		s += src_pitch;
+	}
+
+	return 0;
+}
+
+int drm_vs_swizzle_from_tiled(const void *src, uint32_t src_pitch, void *dst, uint32_t dst_pitch,
+			      uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			      uint32_t plane, const struct drm_vs_rect *rect)
+{
+	vs_swizzle_tile tile;
+	struct drm_vs_rect area;
+	uint8_t *d;
+	uint32_t y;
+
+	if (!src || !dst || _vs_swizzle_setup(format, mod, plane, &tile) ||
+	    _vs_swizzle_size(width, height, &tile))
+		return -EINVAL;
+
+	if (rect) {
+		area = *rect;
+	} else {
+		area.x = 0;
+		area.y = 0;
+		area.w = tile.plane_w;
+		area.h = tile.plane_h;
+	}
+
+	if ((uint64_t)area.x + area.w > tile.plane_w || (uint64_t)area.y + area.h > tile.plane_h ||
+	    (uint64_t)tile.plane_w * tile.cpp > src_pitch || (uint64_t)area.w * tile.cpp > dst_pitch)
+		return -EINVAL;
+
+	for (d = dst, y = area.y; y < area.y + area.h; y++) {
+		vs_detile_row_to_linear(d, (const uint8_t *)src +
+						   _vs_swizzle_line_offset(&tile, src_pitch, y),
+					&tile, area.x, area.x + area.w);
+		d += dst_pitch;
+	}
+
+	return 0;
+}
+
+int drm_vs_swizzle_band(uint32_t height, uint32_t format, uint64_t mod, uint32_t plane,
+			uint32_t num_bands, uint32_t band, uint32_t *y, uint32_t *rows)
+{
+	vs_swizzle_tile tile;
+	uint32_t tile_rows, first, last;
+
+	if (!y || !rows || !num_bands || band >= num_bands ||
+	    _vs_swizzle_setup(format, mod, plane, &tile))
+		return -EINVAL;
+
+	height /= tile.vsub;
+	if (height % tile.tile_h)
+		return -EINVAL;
+
+	tile_rows = height / tile.tile_h;
+	first = (uint64_t)tile_rows * band / num_bands;
+	last = (uint64_t)tile_rows * (band + 1) / num_bands;
+
+	*y = first * tile.tile_h;
+	*rows = (last - first) * tile.tile_h;
+
+	return 0;
+}
@@ -0,0 +1,185 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Clears the tile status of every DEC400 plane, in a buffer laid out by
+ * drm_vs_get_bo_layout and in one dumb buffer per plane as sized by
+ * drm_vs_bo_config, and checks that no byte outside the tile status
+ * regions, nor past the end of the buffer, is written. Exit status 1 when
+ * one is.
+ */
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vs_bo_format_def.h"
+#include "vs_bo_helper.h"
+#include "vs_bo_inline.h"
+
+/* bytes after the buffer that must stay untouched */
+#define VS_CHECK_GUARD 4096
+#define VS_CHECK_FILL 0xa5
+
+#define VS_CHECK_TILE(tile, pixels) DRM_FORMAT_MOD_VS_##tile,
+
+static const uint8_t tile_modes[] = { VS_DEC_TILE_LIST(VS_CHECK_TILE) };
+
+static const uint32_t formats[] = {
+	DRM_FORMAT_ARGB8888, DRM_FORMAT_ARGB2101010, DRM_FORMAT_RGB565,
+	DRM_FORMAT_NV12,     DRM_FORMAT_P010,
+};
+
+static const uint32_t sizes[][2] = {
+	{ 1920, 1080 }, { 3840, 2160 }, { 17, 9 }, { 64, 64 }, { 333, 777 },
+};
+
+/* no fast clear, then fast clear sizes 0 to 3 */
+static uint64_t _vs_check_fc_bits(uint32_t fc)
+{
+	if (!fc)
+		return 0;
+
+	return DRM_FORMAT_MOD_VS_DEC_FC |
+	       ((uint64_t)(fc - 1) << DRM_FORMAT_MOD_VS_DEC_FC_SIZE_SHIFT);
+}
+
+static bool _vs_check_in_ts(const drm_vs_bo_layout *layout, uint64_t offset)
+{
+	uint32_t i;
+
+	for (i = 0; i < layout->num_planes; i++) {
+		if (fourcc_mod_vs_is_compressed(layout->modifiers[i]) &&
+		    offset >= layout->ts_offsets[i] &&
+		    offset < layout->ts_offsets[i] + layout->ts_size[i])
+			return true;
+	}
+
+	return false;
+}
+
+/* bytes of @buf changed outside [@start, @end) */
+static uint64_t _vs_check_written(const uint8_t *buf, uint64_t size, uint64_t start, uint64_t end)
+{
+	uint64_t offset, bad = 0;
+
+	for (offset = 0; offset < size; offset++) {
+		if (buf[offset] != VS_CHECK_FILL && (offset < start || offset >= end))
+			bad++;
+	}
+
+	return bad;
+}
+
+/* return the number of bytes written outside the tile status regions */
+static uint64_t _vs_check_clear(uint32_t width, uint32_t height, uint32_t format, uint64_t mod)
+{
+	drm_vs_bo_param bo_param[4];
+	drm_vs_bo_layout layout;
+	uint64_t modifiers[4], offset, size, ts, bad = 0;
+	uint8_t *buf;
+	uint32_t i;
+
+	drm_vs_get_align_size(&width, &height, format, mod);
+	if (drm_vs_get_bo_layout(width, height, format, mod, &layout) ||
+	    drm_vs_bo_config_ext(width, height, format, mod, bo_param, modifiers))
+		return 0;
+
+	/* all planes in one buffer object */
+	buf = malloc(layout.size + VS_CHECK_GUARD);
+	if (!buf)
+		return 0;
+	memset(buf, VS_CHECK_FILL, layout.size + VS_CHECK_GUARD);
+
+	for (i = 0; i < layout.num_planes; i++) {
+		if (fourcc_mod_vs_is_compressed(layout.modifiers[i]))
+			drm_vs_clear_tile_status(buf + layout.ts_offsets[i], &bo_param[i],
+						 layout.modifiers[i], 0xff00ff00);
+	}
+
+	for (offset = 0; offset < layout.size + VS_CHECK_GUARD; offset++) {
+		if (buf[offset] != VS_CHECK_FILL &&
+		    (offset >= layout.size || !_vs_check_in_ts(&layout, offset)))
+			bad++;
+	}
+
+	free(buf);
+
+	/* one dumb buffer per plane, tile status after the plane data */
+	for (i = 0; i < layout.num_planes; i++) {
+		if (!fourcc_mod_vs_is_compressed(layout.modifiers[i]))
+			continue;
+
+		size = (uint64_t)bo_param[i].width * bo_param[i].bpp / 8 * bo_param[i].height;
+		ts = layout.ts_offsets[i] - layout.offsets[i];
+		buf = malloc(size + VS_CHECK_GUARD);
+		if (!buf)
+			return bad;
+		memset(buf, VS_CHECK_FILL, size + VS_CHECK_GUARD);
+
+		drm_vs_clear_tile_status(buf + ts, &bo_param[i], layout.modifiers[i], 0xff00ff00);
+		bad += _vs_check_written(buf, size + VS_CHECK_GUARD, ts,
+					 VS_MIN(ts + bo_param[i].ts_buf_size, size));
+
+		free(buf);
+	}
+
+	return bad;
+}
+
+int main(void)
+{
+	uint32_t f, t, s, fc, failed = 0, checked = 0;
+	uint64_t mod, bad;
+
+	for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+		for (t = 0; t < sizeof(tile_modes) / sizeof(tile_modes[0]); t++) {
+			for (fc = 0; fc <= 4; fc++) {
+				mod = fourcc_mod_vs_dec_code(tile_modes[t],
+							     DRM_FORMAT_MOD_VS_DEC_ALIGN_32) |
+				      _vs_check_fc_bits(fc);
+				for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+					checked++;
+					bad = _vs_check_clear(sizes[s][0], sizes[s][1], formats[f],
+							      mod);
+					if (!bad)
+						continue;
+					if (failed++ < 16)
+						printf("%.4s mod 0x%llx %ux%u: %llu bytes out of bounds\n",
+						       (const char *)&formats[f],
+						       (unsigned long long)mod, sizes[s][0],
+						       sizes[s][1], (unsigned long long)bad);
+				}
+			}
+		}
+	}
+
+	printf("%u tile status clears checked, %u out of bounds\n", checked, failed);
+
+	return failed ? 1 : 0;
+}
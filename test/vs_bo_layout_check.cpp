@@ -0,0 +1,83 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Compares vs_bo_layout.hpp with the C library over every listed format,
+ * modifier type, tile mode and a set of sizes, exit status 1 on mismatch.
+ * Results go to stdout, stderr has the messages of the library.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "vs_bo_layout.hpp"
+
+using nv12_dec = vs::layout<DRM_FORMAT_NV12, fourcc_mod_vs_dec_code(DRM_FORMAT_MOD_VS_DEC_TILE_32X8,
+								    DRM_FORMAT_MOD_VS_DEC_ALIGN_32)>;
+static_assert(nv12_dec::config(1920, 1080).ret == 0 && nv12_dec::num_planes == 2);
+
+static const uint32_t sizes[][2] = {
+	{ 0, 0 },	{ 1, 1 },	  { 3, 5 },	  { 17, 9 },	  { 100, 3 },
+	{ 333, 777 },	{ 720, 1612 },	  { 1920, 1080 }, { 2700, 2600 }, { 3840, 2160 },
+	{ 70000, 70000 }, { 4000000000u, 3 },
+};
+
+static const uint64_t extras[] = {
+	0,
+	DRM_FORMAT_MOD_VS_DEC_LOSSY,
+	DRM_FORMAT_MOD_VS_DEC_FC | (2ull << DRM_FORMAT_MOD_VS_DEC_FC_SIZE_SHIFT),
+	DRM_FORMAT_MOD_VS_CUSTOM_FORMAT,
+	DRM_FORMAT_MOD_VS_DEC_ALIGN_32,
+};
+
+int main(void)
+{
+	uint64_t checked = 0, failed = 0, mod;
+
+	/* entry 0 stands for the unlisted formats */
+	for (const vs::detail::format_entry &fmt : vs::detail::formats) {
+		for (uint64_t type = 0; type < 8; type++) {
+			for (uint64_t tile = 0; tile < 64; tile++) {
+				for (uint64_t extra : extras) {
+					mod = fourcc_mod_vs_code(type, tile) | extra;
+					for (const auto &size : sizes) {
+						checked++;
+						if (vs::check_against_c(size[0], size[1], fmt.format, mod))
+							continue;
+						if (failed++ < 16)
+							printf("mismatch %.4s mod 0x%" PRIx64 " %ux%u\n",
+							       (const char *)&fmt.format, mod, size[0],
+							       size[1]);
+					}
+				}
+			}
+		}
+	}
+
+	printf("%" PRIu64 " layouts checked, %" PRIu64 " mismatches\n", checked, failed);
+
+	return failed ? 1 : 0;
+}
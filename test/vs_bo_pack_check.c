@@ -0,0 +1,317 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Packs random images into every custom layout with drm_vs_pack_custom_ext,
+ * on the rows drm_vs_pack_isa reports, compares them with a bit by bit
+ * reference, then unpacks them back and compares the standard image with
+ * the one the reference expects. Bytes past the samples of the custom
+ * rows must stay untouched. Exit status 1 on any mismatch.
+ */
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vs_bo_helper.h"
+#include "vs_bo_pack.h"
+
+#define VS_CHECK_FILL 0xa5
+
+/* how the reference packs a row, see vs_bo_pack.h */
+typedef enum _vs_check_kind {
+	VS_CHECK_10BIT,
+	VS_CHECK_10BIT8,
+	VS_CHECK_3IN32,
+	VS_CHECK_LUMA10,
+	VS_CHECK_RGB_PLANAR,
+	VS_CHECK_565A8,
+} vs_check_kind;
+
+static const struct {
+	uint32_t format;
+	uint32_t source;
+	vs_check_kind kind;
+} layouts[] = {
+	{ DRM_FORMAT_RGB888, DRM_FORMAT_XRGB8888, VS_CHECK_RGB_PLANAR },
+	{ DRM_FORMAT_BGR888, DRM_FORMAT_XRGB8888, VS_CHECK_RGB_PLANAR },
+	{ DRM_FORMAT_NV12, DRM_FORMAT_P010, VS_CHECK_10BIT },
+	{ DRM_FORMAT_NV12, DRM_FORMAT_NV12, VS_CHECK_10BIT8 },
+	{ DRM_FORMAT_YUV420_10BIT, DRM_FORMAT_P010, VS_CHECK_3IN32 },
+	{ DRM_FORMAT_P016, DRM_FORMAT_P010, VS_CHECK_3IN32 },
+	{ DRM_FORMAT_Y0L0, DRM_FORMAT_P010, VS_CHECK_LUMA10 },
+	{ DRM_FORMAT_RGB565_A8, DRM_FORMAT_ARGB8888, VS_CHECK_565A8 },
+	{ DRM_FORMAT_BGR565_A8, DRM_FORMAT_ARGB8888, VS_CHECK_565A8 },
+};
+
+/* whole vector blocks, tails of every length, and odd pitches */
+static const uint32_t sizes[][2] = {
+	{ 3840, 2 }, { 1922, 4 }, { 1000, 2 }, { 100, 4 }, { 64, 4 }, { 37, 8 }, { 13, 2 }, { 2, 2 },
+};
+
+static uint32_t _vs_check_cpp(uint32_t source)
+{
+	switch (source) {
+	case DRM_FORMAT_NV12:
+		return 1;
+	case DRM_FORMAT_P010:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+static uint32_t _vs_check_load16(const uint8_t *p)
+{
+	return p[0] | p[1] << 8;
+}
+
+static void _vs_check_store16(uint8_t *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+/* write @bits bits of @v at bit @pos of @row, low bits first */
+static void _vs_check_put_bits(uint8_t *row, uint64_t pos, uint32_t v, uint32_t bits)
+{
+	uint32_t i;
+
+	for (i = 0; i < bits; i++, pos++) {
+		if (v >> i & 1)
+			row[pos / 8] |= 1 << (pos % 8);
+	}
+}
+
+static uint32_t _vs_check_expand(uint32_t c, uint32_t bits)
+{
+	return c << (8 - bits) | c >> (2 * bits - 8);
+}
+
+/* samples, or pixels for the RGB kinds, held by @bytes of a custom row */
+static uint32_t _vs_check_count(vs_check_kind kind, uint32_t bytes)
+{
+	switch (kind) {
+	case VS_CHECK_10BIT:
+	case VS_CHECK_10BIT8:
+		return (uint64_t)bytes * 8 / 10;
+	case VS_CHECK_3IN32:
+		return bytes / 4 * 3;
+	case VS_CHECK_LUMA10:
+		return bytes / 2;
+	case VS_CHECK_565A8:
+		return bytes / 3;
+	default:
+		return bytes;
+	}
+}
+
+/* bytes of a custom row taken by @n samples or pixels, the rest is left alone */
+static uint32_t _vs_check_used(vs_check_kind kind, uint32_t n)
+{
+	switch (kind) {
+	case VS_CHECK_10BIT:
+	case VS_CHECK_10BIT8:
+		return ((uint64_t)n * 10 + 7) / 8;
+	case VS_CHECK_3IN32:
+		return n / 3 * 4;
+	case VS_CHECK_LUMA10:
+		return n * 2;
+	case VS_CHECK_565A8:
+		return n * 3;
+	default:
+		return n;
+	}
+}
+
+/*
+ * Reference of one row: pack @n samples or pixels of @std into @custom,
+ * zeroed by the caller, and write the unpacked standard row into @back.
+ */
+static void _vs_check_ref_row(uint32_t format, vs_check_kind kind, const uint8_t *std,
+			      uint32_t n, uint8_t *const custom[3], uint8_t *back)
+{
+	uint32_t x, k, s, b, g, r, rgb, hi, lo;
+	/* byte of the XRGB8888 pixel in each RGB plane */
+	const uint32_t order[3] = { format == DRM_FORMAT_RGB888 ? 2 : 0, 1,
+				    format == DRM_FORMAT_RGB888 ? 0 : 2 };
+
+	for (x = 0; x < n; x++) {
+		switch (kind) {
+		case VS_CHECK_10BIT:
+			s = _vs_check_load16(std + x * 2) >> 6;
+			_vs_check_put_bits(custom[0], (uint64_t)x * 10, s, 10);
+			_vs_check_store16(back + x * 2, s << 6);
+			break;
+		case VS_CHECK_10BIT8:
+			_vs_check_put_bits(custom[0], (uint64_t)x * 10, std[x] << 2, 10);
+			back[x] = std[x];
+			break;
+		case VS_CHECK_3IN32:
+			s = _vs_check_load16(std + x * 2) >> 6;
+			_vs_check_put_bits(custom[0], (uint64_t)x / 3 * 32 + x % 3 * 10, s, 10);
+			_vs_check_store16(back + x * 2, s << 6);
+			break;
+		case VS_CHECK_LUMA10:
+			s = _vs_check_load16(std + x * 2) >> 6;
+			_vs_check_store16(custom[0] + x * 2, s);
+			_vs_check_store16(back + x * 2, s << 6);
+			break;
+		case VS_CHECK_RGB_PLANAR:
+			for (k = 0; k < 3; k++) {
+				custom[k][x] = std[x * 4 + order[k]];
+				back[x * 4 + order[k]] = std[x * 4 + order[k]];
+			}
+			back[x * 4 + 3] = 0xff;
+			break;
+		case VS_CHECK_565A8:
+			b = std[x * 4] >> 3;
+			g = std[x * 4 + 1] >> 2;
+			r = std[x * 4 + 2] >> 3;
+			hi = format == DRM_FORMAT_BGR565_A8 ? b : r;
+			lo = format == DRM_FORMAT_BGR565_A8 ? r : b;
+			rgb = hi << 11 | g << 5 | lo;
+			_vs_check_store16(custom[0] + x * 3, rgb);
+			custom[0][x * 3 + 2] = std[x * 4 + 3];
+			back[x * 4] = _vs_check_expand(b, 5);
+			back[x * 4 + 1] = _vs_check_expand(g, 6);
+			back[x * 4 + 2] = _vs_check_expand(r, 5);
+			back[x * 4 + 3] = std[x * 4 + 3];
+			break;
+		}
+	}
+}
+
+/* return the number of mismatching rows */
+static uint32_t _vs_check_pack(uint32_t l, uint32_t width, uint32_t height)
+{
+	uint32_t format = layouts[l].format, source = layouts[l].source;
+	uint32_t std_pitches[4] = { 0 }, custom_pitches[4] = { 0 }, n[4], used[4];
+	uint8_t *std[4] = { 0 }, *custom[4] = { 0 }, *back[4] = { 0 }, *ref[4] = { 0 };
+	uint8_t *ref_rows[3], *ref_back, *row;
+	uint32_t i, k, p, x, y, rows, planes, cpp = _vs_check_cpp(source), bad = 0;
+	drm_vs_format_desc desc;
+	size_t size;
+
+	if (drm_vs_get_format_desc(format, DRM_FORMAT_MOD_VS_CUSTOM_FORMAT, &desc))
+		return 1;
+
+	/* planar RGB comes from a single XRGB8888 plane */
+	planes = layouts[l].kind == VS_CHECK_RGB_PLANAR ? 1 : desc.num_planes;
+	for (i = 0; i < desc.num_planes; i++) {
+		custom_pitches[i] = width / desc.hsub[i] * desc.bpp[i] / 8;
+		n[i] = _vs_check_count(layouts[l].kind, custom_pitches[i]);
+		used[i] = _vs_check_used(layouts[l].kind, n[i]);
+		custom_pitches[i] += 3;
+		size = (size_t)custom_pitches[i] * height;
+		custom[i] = malloc(size);
+		ref[i] = calloc(size, 1);
+		if (!custom[i] || !ref[i])
+			goto out;
+		memset(custom[i], VS_CHECK_FILL, size);
+	}
+	for (i = 0; i < planes; i++) {
+		std_pitches[i] = n[i] * cpp + 7;
+		size = (size_t)std_pitches[i] * height;
+		std[i] = malloc(size);
+		back[i] = malloc(size);
+		if (!std[i] || !back[i])
+			goto out;
+		for (k = 0; k < size; k++)
+			std[i][k] = rand();
+	}
+
+	if (drm_vs_pack_custom_ext(format, source, width, height, (const void *const *)std,
+				   std_pitches, (void *const *)custom, custom_pitches) ||
+	    drm_vs_unpack_custom_ext(format, source, width, height, (const void *const *)custom,
+				     custom_pitches, (void *const *)back, std_pitches)) {
+		bad = 1;
+		goto out;
+	}
+
+	/* std_pitches[0] is the widest, chroma rows hold as many samples or fewer */
+	ref_back = malloc(std_pitches[0]);
+	if (!ref_back)
+		goto out;
+
+	for (i = 0; i < planes; i++) {
+		rows = height / desc.vsub[i];
+		for (y = 0; y < rows; y++) {
+			for (k = 0; k < 3; k++)
+				ref_rows[k] = ref[planes == 1 ? k : i] +
+					      (size_t)custom_pitches[planes == 1 ? k : i] * y;
+			memset(ref_back, 0, std_pitches[0]);
+			_vs_check_ref_row(format, layouts[l].kind, std[i] + (size_t)std_pitches[i] * y,
+					  n[i], ref_rows, ref_back);
+
+			for (k = 0; k < (planes == 1 ? desc.num_planes : 1); k++) {
+				p = planes == 1 ? k : i;
+				row = custom[p] + (size_t)custom_pitches[p] * y;
+				if (memcmp(row, ref_rows[k], used[p]))
+					bad++;
+				for (x = used[p]; x < custom_pitches[p]; x++)
+					bad += row[x] != VS_CHECK_FILL;
+			}
+			if (memcmp(back[i] + (size_t)std_pitches[i] * y, ref_back, n[i] * cpp))
+				bad++;
+		}
+	}
+
+	free(ref_back);
+out:
+	for (i = 0; i < 4; i++) {
+		free(std[i]);
+		free(custom[i]);
+		free(back[i]);
+		free(ref[i]);
+	}
+
+	return bad;
+}
+
+int main(void)
+{
+	uint32_t l, s, failed = 0, checked = 0;
+
+	for (l = 0; l < sizeof(layouts) / sizeof(layouts[0]); l++) {
+		for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			checked++;
+			if (!_vs_check_pack(l, sizes[s][0], sizes[s][1]))
+				continue;
+			if (failed++ < 16)
+				printf("%.4s from %.4s %ux%u: mismatch\n",
+				       (const char *)&layouts[l].format,
+				       (const char *)&layouts[l].source, sizes[s][0], sizes[s][1]);
+		}
+	}
+
+	printf("%u custom layouts round tripped on %s rows, %u mismatches\n", checked,
+	       drm_vs_pack_isa(), failed);
+
+	return failed ? 1 : 0;
+}
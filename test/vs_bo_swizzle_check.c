@@ -0,0 +1,208 @@
+/***************************************************************************
+*    Copyright 2012 - 2023 Vivante Corporation, Santa Clara, California.
+*    All Rights Reserved.
+*
+*    Permission is hereby granted, free of charge, to any person obtaining
+*    a copy of this software and associated documentation files (the
+*    'Software'), to deal in the Software without restriction, including
+*    without limitation the rights to use, copy, modify, merge, publish,
+*    distribute, sub license, and/or sell copies of the Software, and to
+*    permit persons to whom the Software is furnished to do so, subject
+*    to the following conditions:
+*
+*    The above copyright notice and this permission notice (including the
+*    next paragraph) shall be included in all copies or substantial
+*    portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+*    IN NO EVENT SHALL VIVANTE AND/OR ITS SUPPLIERS BE LIABLE FOR ANY
+*    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+*    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+*    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Swizzles random planes into every tile mode of drm_vs_swizzle_to_tiled,
+ * band by band, on the rows drm_vs_swizzle_isa reports, then copies the
+ * whole plane and a sub-rectangle back with drm_vs_swizzle_from_tiled and
+ * compares them with the source. The linear copies are 64 byte aligned so
+ * that the streaming stores run. Bytes past the tiled plane must stay
+ * untouched. Exit status 1 on any mismatch.
+ */
+
+#include <drm/vs_drm.h>
+#include <drm/vs_drm_fourcc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vs_bo_helper.h"
+#include "vs_bo_swizzle.h"
+
+/* bytes after the tiled plane that must stay untouched */
+#define VS_CHECK_GUARD 4096
+#define VS_CHECK_FILL 0xa5
+#define VS_CHECK_ALIGN 64
+#define VS_CHECK_BANDS 3
+
+static const uint64_t norm_modes[] = {
+	DRM_FORMAT_MOD_VS_LINEAR,
+	DRM_FORMAT_MOD_VS_TILE_8X8,
+	DRM_FORMAT_MOD_VS_TILE_8X4,
+	DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR,
+	DRM_FORMAT_MOD_VS_SUPER_TILED_XMAJOR_8X4,
+	DRM_FORMAT_MOD_VS_SUPER_TILED_YMAJOR_4X8,
+	DRM_FORMAT_MOD_VS_TILE_MODE4X4,
+	DRM_FORMAT_MOD_VS_TILE_32X8,
+	DRM_FORMAT_MOD_VS_TILE_32X8_A,
+	DRM_FORMAT_MOD_VS_TILE_16X16,
+	DRM_FORMAT_MOD_VS_TILE_16X4,
+	DRM_FORMAT_MOD_VS_TILE_8X8_SUPERTILE_X,
+	DRM_FORMAT_MOD_VS_TILE_32X8_YUVSP8X8,
+	DRM_FORMAT_MOD_VS_TILE_16X8_YUVSP8X8,
+	DRM_FORMAT_MOD_VS_TILE_8X8_UNIT2X2,
+	DRM_FORMAT_MOD_VS_TILE_8X4_UNIT2X2,
+};
+
+static const uint32_t formats[] = {
+	DRM_FORMAT_ARGB8888, DRM_FORMAT_RGB565, DRM_FORMAT_RGB888,
+	DRM_FORMAT_ARGB16161616F, DRM_FORMAT_NV12, DRM_FORMAT_P010,
+};
+
+static const uint32_t sizes[][2] = {
+	{ 1920, 1080 }, { 64, 64 }, { 333, 777 },
+};
+
+static void *_vs_check_alloc(size_t size)
+{
+	return aligned_alloc(VS_CHECK_ALIGN, (size + VS_CHECK_ALIGN - 1) & ~(size_t)(VS_CHECK_ALIGN - 1));
+}
+
+/* rows of @linear from (@x, @y) against @w x @h pixels of @copy, return the mismatching rows */
+static uint32_t _vs_check_compare(const uint8_t *linear, uint32_t linear_pitch, const uint8_t *copy,
+				  uint32_t copy_pitch, uint32_t cpp, const struct drm_vs_rect *rect)
+{
+	uint32_t y, bad = 0;
+
+	for (y = 0; y < rect->h; y++) {
+		if (memcmp(linear + (size_t)(rect->y + y) * linear_pitch + (size_t)rect->x * cpp,
+			   copy + (size_t)y * copy_pitch, (size_t)rect->w * cpp))
+			bad++;
+	}
+
+	return bad;
+}
+
+/*
+ * Round trip @plane, return 0 when it matches, 1 when it does not and
+ * -1 when the plane cannot be swizzled.
+ */
+static int _vs_check_plane(uint32_t width, uint32_t height, uint32_t format, uint64_t mod,
+			   const drm_vs_bo_layout *layout, const drm_vs_format_desc *desc,
+			   uint32_t plane)
+{
+	uint32_t cpp = desc->bpp[plane] / 8, w = width / desc->hsub[plane];
+	uint32_t h = height / desc->vsub[plane], pitch, band, y, rows;
+	uint8_t *linear = NULL, *tiled = NULL, *copy = NULL;
+	uint64_t tiled_size = (uint64_t)layout->pitches[plane] * h, k;
+	struct drm_vs_rect rect;
+	int ret = 1;
+
+	if (!cpp || desc->bpp[plane] % 8)
+		return -1;
+
+	pitch = (w * cpp + VS_CHECK_ALIGN - 1) & ~(VS_CHECK_ALIGN - 1);
+	linear = _vs_check_alloc((size_t)pitch * h);
+	copy = _vs_check_alloc((size_t)pitch * h);
+	tiled = _vs_check_alloc(tiled_size + VS_CHECK_GUARD);
+	if (!linear || !copy || !tiled)
+		goto out;
+
+	for (k = 0; k < (uint64_t)pitch * h; k++)
+		linear[k] = rand();
+	memset(tiled, VS_CHECK_FILL, tiled_size + VS_CHECK_GUARD);
+
+	for (band = 0; band < VS_CHECK_BANDS; band++) {
+		if (drm_vs_swizzle_band(height, format, mod, plane, VS_CHECK_BANDS, band, &y, &rows) ||
+		    drm_vs_swizzle_to_tiled(linear, pitch, tiled, layout->pitches[plane], width,
+					    height, format, mod, plane, y, rows)) {
+			ret = -1;
+			goto out;
+		}
+	}
+
+	ret = 0;
+	for (k = tiled_size; k < tiled_size + VS_CHECK_GUARD; k++)
+		ret |= tiled[k] != VS_CHECK_FILL;
+
+	/* the whole plane, then a rectangle at odd pixels */
+	rect.x = 0;
+	rect.y = 0;
+	rect.w = w;
+	rect.h = h;
+	if (drm_vs_swizzle_from_tiled(tiled, layout->pitches[plane], copy, pitch, width, height,
+				      format, mod, plane, NULL) ||
+	    _vs_check_compare(linear, pitch, copy, pitch, cpp, &rect))
+		ret = 1;
+
+	rect.x = w / 3 | 1;
+	rect.y = h / 5 | 1;
+	rect.w = w / 2 | 1;
+	rect.h = h / 3 | 1;
+	if (drm_vs_swizzle_from_tiled(tiled, layout->pitches[plane], copy, pitch, width, height,
+				      format, mod, plane, &rect) ||
+	    _vs_check_compare(linear, pitch, copy, pitch, cpp, &rect))
+		ret = 1;
+
+out:
+	free(linear);
+	free(copy);
+	free(tiled);
+
+	return ret;
+}
+
+int main(void)
+{
+	uint32_t m, f, s, i, width, height, failed = 0, checked = 0;
+	drm_vs_format_desc desc;
+	drm_vs_bo_layout layout;
+	uint64_t mod;
+	int ret;
+
+	for (m = 0; m < sizeof(norm_modes) / sizeof(norm_modes[0]); m++) {
+		mod = fourcc_mod_vs_norm_code(norm_modes[m]);
+		for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+			for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+				width = sizes[s][0];
+				height = sizes[s][1];
+				drm_vs_get_align_size(&width, &height, formats[f], mod);
+				if (drm_vs_get_format_desc(formats[f], mod, &desc) ||
+				    drm_vs_get_bo_layout(width, height, formats[f], mod, &layout))
+					continue;
+
+				for (i = 0; i < desc.num_planes; i++) {
+					ret = _vs_check_plane(width, height, formats[f], mod,
+							      &layout, &desc, i);
+					if (ret < 0)
+						continue;
+					checked++;
+					if (!ret)
+						continue;
+					if (failed++ < 16)
+						printf("%.4s mod 0x%llx %ux%u plane %u: mismatch\n",
+						       (const char *)&formats[f],
+						       (unsigned long long)mod, width, height, i);
+				}
+			}
+		}
+	}
+
+	printf("%u planes swizzled and detiled on %s rows, %u mismatches\n", checked,
+	       drm_vs_swizzle_isa(), failed);
+
+	return failed || !checked ? 1 : 0;
+}